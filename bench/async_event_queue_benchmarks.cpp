@@ -0,0 +1,65 @@
+#include "bench_events.hpp"
+#include <evnt/evnt.hpp>
+#include <benchmark/benchmark.h>
+
+namespace
+{
+constexpr std::size_t sync_period = 1024;
+
+evnt::async_event_queue shared_queue;
+
+// Every thread is a producer, the first one also consumes the queue from time to time
+// so that its memory stays bounded.
+template <std::size_t event_size>
+void push(benchmark::State& state)
+{
+    if (state.thread_index() == 0)
+        shared_queue.reserve<sized_event<event_size>>(sync_period * state.threads());
+
+    std::size_t count = 0;
+    for (auto _ : state)
+    {
+        shared_queue.push(sized_event<event_size>{});
+        if (state.thread_index() == 0 && ++count % sync_period == 0)
+            shared_queue.sync();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * event_size);
+}
+
+template <std::size_t event_size, evnt::async_event_queue::push_mode mode>
+void sync_and_emit(benchmark::State& state)
+{
+    evnt::async_event_queue queue;
+    queue.reserve<sized_event<event_size>>(state.range(0));
+    queue.set_push_mode<sized_event<event_size>>(mode);
+    evnt::event_manager event_manager;
+    std::size_t counter = 0;
+    event_manager.connect<sized_event<event_size>>([&counter](sized_event<event_size>&) { ++counter; });
+
+    for (auto _ : state)
+    {
+        for (int64_t i = 0; i < state.range(0); ++i)
+            queue.push(sized_event<event_size>{});
+        queue.sync_and_emit_events(event_manager);
+        benchmark::DoNotOptimize(counter);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <std::size_t event_size>
+void locked_sync_and_emit(benchmark::State& state)
+{
+    sync_and_emit<event_size, evnt::async_event_queue::push_mode::locked>(state);
+}
+
+template <std::size_t event_size>
+void ring_sync_and_emit(benchmark::State& state)
+{
+    sync_and_emit<event_size, evnt::async_event_queue::push_mode::ring>(state);
+}
+}
+
+EVNT_BENCHMARK_EVENT_SIZES(push, ->ThreadRange(1, 32)->UseRealTime());
+EVNT_BENCHMARK_EVENT_SIZES(locked_sync_and_emit, ->Arg(1)->Arg(64)->Arg(1024));
+EVNT_BENCHMARK_EVENT_SIZES(ring_sync_and_emit, ->Arg(1)->Arg(64)->Arg(1024));
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Event whose size is exactly event_size bytes (from 4 B to 1 KB in the benchmarks).
+template <std::size_t event_size>
+class sized_event
+{
+public:
+    std::array<std::uint8_t, event_size> payload;
+};
+
+#define EVNT_BENCHMARK_EVENT_SIZES(benchmark_template, ...) \
+    BENCHMARK_TEMPLATE(benchmark_template, 4) __VA_ARGS__; \
+    BENCHMARK_TEMPLATE(benchmark_template, 32) __VA_ARGS__; \
+    BENCHMARK_TEMPLATE(benchmark_template, 256) __VA_ARGS__; \
+    BENCHMARK_TEMPLATE(benchmark_template, 1024) __VA_ARGS__
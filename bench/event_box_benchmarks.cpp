@@ -0,0 +1,108 @@
+#include "bench_events.hpp"
+#include <evnt/evnt.hpp>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+namespace
+{
+// Emits one event to state.range(0) connected boxes, then drains every box.
+template <std::size_t event_size>
+void fan_out(benchmark::State& state)
+{
+    evnt::event_manager event_manager;
+    std::vector<std::unique_ptr<evnt::event_box>> event_boxes;
+    std::size_t counter = 0;
+    for (int64_t i = 0; i < state.range(0); ++i)
+    {
+        std::unique_ptr<evnt::event_box>& event_box = event_boxes.emplace_back(std::make_unique<evnt::event_box>());
+        event_box->connect<sized_event<event_size>>([&counter](sized_event<event_size>&) { ++counter; });
+        event_manager.connect(*event_box);
+    }
+    sized_event<event_size> event{};
+
+    for (auto _ : state)
+    {
+        event_manager.emit(event);
+        for (std::unique_ptr<evnt::event_box>& event_box : event_boxes)
+            event_box->emit_received_events();
+        benchmark::DoNotOptimize(counter);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * event_size);
+}
+
+// Emits 1000 events to 8 connected boxes, one by one or staged in an event_batch, then drains every box.
+void emit_loop(benchmark::State& state)
+{
+    constexpr std::size_t number_of_events = 1000;
+    evnt::event_manager event_manager;
+    std::vector<std::unique_ptr<evnt::event_box>> event_boxes;
+    std::size_t counter = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        std::unique_ptr<evnt::event_box>& event_box = event_boxes.emplace_back(std::make_unique<evnt::event_box>());
+        event_box->connect<sized_event<16>>([&counter](sized_event<16>&) { ++counter; });
+        event_manager.connect(*event_box);
+    }
+    const bool batched = state.range(0) != 0;
+    evnt::event_batch batch(event_manager);
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < number_of_events; ++i)
+        {
+            sized_event<16> event{};
+            if (batched)
+                batch.emit(event);
+            else
+                event_manager.emit(event);
+        }
+        batch.flush();
+        for (std::unique_ptr<evnt::event_box>& event_box : event_boxes)
+            event_box->emit_received_events();
+        benchmark::DoNotOptimize(counter);
+    }
+    state.SetItemsProcessed(state.iterations() * number_of_events);
+}
+
+// Emits a batch of 64 events to a root box with 10 child boxes of 10 leaf boxes each, then drains the tree.
+template <std::size_t event_size>
+void tree_fan_out(benchmark::State& state)
+{
+    evnt::event_manager event_manager;
+    evnt::event_box root_box;
+    event_manager.connect(root_box);
+    std::vector<std::unique_ptr<evnt::event_box>> inner_boxes;
+    std::vector<std::unique_ptr<evnt::event_box>> leaf_boxes;
+    std::size_t counter = 0;
+    for (int i = 0; i < 10; ++i)
+    {
+        evnt::event_box& inner_box = *inner_boxes.emplace_back(std::make_unique<evnt::event_box>());
+        root_box.connect(inner_box);
+        for (int j = 0; j < 10; ++j)
+        {
+            evnt::event_box& leaf_box = *leaf_boxes.emplace_back(std::make_unique<evnt::event_box>());
+            leaf_box.connect<sized_event<event_size>>([&counter](sized_event<event_size>&) { ++counter; });
+            inner_box.connect(leaf_box);
+        }
+    }
+    std::vector<sized_event<event_size>> events(64);
+
+    for (auto _ : state)
+    {
+        event_manager.emit(events);
+        root_box.emit_received_events();
+        for (std::unique_ptr<evnt::event_box>& inner_box : inner_boxes)
+            inner_box->emit_received_events();
+        for (std::unique_ptr<evnt::event_box>& leaf_box : leaf_boxes)
+            leaf_box->emit_received_events();
+        benchmark::DoNotOptimize(counter);
+    }
+    state.SetItemsProcessed(state.iterations() * events.size() * leaf_boxes.size());
+}
+}
+
+EVNT_BENCHMARK_EVENT_SIZES(fan_out, ->Arg(1)->Arg(8)->Arg(32));
+EVNT_BENCHMARK_EVENT_SIZES(tree_fan_out);
+BENCHMARK(emit_loop)->ArgName("batched")->Arg(0)->Arg(1);
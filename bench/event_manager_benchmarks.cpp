@@ -0,0 +1,108 @@
+#include "bench_events.hpp"
+#include <evnt/evnt.hpp>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace
+{
+constexpr std::size_t batch_size = 64;
+
+template <std::size_t event_size>
+void connect_receivers(evnt::event_manager& event_manager, std::size_t number_of_receivers, std::size_t& counter)
+{
+    for (std::size_t i = 0; i < number_of_receivers; ++i)
+        event_manager.connect<sized_event<event_size>>([&counter](sized_event<event_size>& event)
+        {
+            counter += event.payload[0];
+        });
+}
+
+template <std::size_t event_size>
+void emit_single(benchmark::State& state)
+{
+    evnt::event_manager event_manager;
+    std::size_t counter = 0;
+    connect_receivers<event_size>(event_manager, state.range(0), counter);
+    sized_event<event_size> event{};
+    event.payload[0] = 1;
+
+    for (auto _ : state)
+    {
+        event_manager.emit(event);
+        benchmark::DoNotOptimize(counter);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * event_size);
+}
+
+template <std::size_t event_size>
+void emit_vector(benchmark::State& state)
+{
+    evnt::event_manager event_manager;
+    std::size_t counter = 0;
+    connect_receivers<event_size>(event_manager, state.range(0), counter);
+    std::vector<sized_event<event_size>> events(batch_size);
+    for (sized_event<event_size>& event : events)
+        event.payload[0] = 1;
+
+    for (auto _ : state)
+    {
+        event_manager.emit(events);
+        benchmark::DoNotOptimize(counter);
+    }
+    state.SetItemsProcessed(state.iterations() * batch_size);
+    state.SetBytesProcessed(state.iterations() * batch_size * event_size);
+}
+
+template <std::size_t event_size>
+void static_emit_single(benchmark::State& state)
+{
+    evnt::static_event_manager<sized_event<event_size>> event_manager;
+    std::size_t counter = 0;
+    for (int64_t i = 0; i < state.range(0); ++i)
+        event_manager.template connect<sized_event<event_size>>([&counter](sized_event<event_size>& event)
+        {
+            counter += event.payload[0];
+        });
+    sized_event<event_size> event{};
+    event.payload[0] = 1;
+
+    for (auto _ : state)
+    {
+        event_manager.emit(event);
+        benchmark::DoNotOptimize(counter);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * event_size);
+}
+
+class receiver : public evnt::event_listener<sized_event<4>>
+{
+public:
+    void receive(sized_event<4>& event)
+    {
+        benchmark::DoNotOptimize(event);
+    }
+};
+
+void connect_disconnect_listener(benchmark::State& state)
+{
+    evnt::event_manager event_manager;
+    std::vector<receiver> receivers(state.range(0));
+    for (receiver& listener : receivers)
+        event_manager.connect<sized_event<4>>(listener);
+    receiver listener;
+
+    for (auto _ : state)
+    {
+        event_manager.connect<sized_event<4>>(listener);
+        listener.disconnect<sized_event<4>>();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+}
+
+EVNT_BENCHMARK_EVENT_SIZES(emit_single, ->Arg(0)->Arg(1)->Arg(10)->Arg(1000));
+EVNT_BENCHMARK_EVENT_SIZES(static_emit_single, ->Arg(0)->Arg(1)->Arg(10)->Arg(1000));
+EVNT_BENCHMARK_EVENT_SIZES(emit_vector, ->Arg(0)->Arg(1)->Arg(10)->Arg(1000));
+BENCHMARK(connect_disconnect_listener)->Arg(0)->Arg(10)->Arg(1000);
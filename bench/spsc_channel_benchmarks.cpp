@@ -0,0 +1,51 @@
+#include "bench_events.hpp"
+#include <evnt/evnt.hpp>
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <thread>
+
+namespace
+{
+// Round trip of an event between two threads through two channels (state.range(0): wait_policy).
+void ping_pong(benchmark::State& state)
+{
+    const evnt::wait_policy policy = static_cast<evnt::wait_policy>(state.range(0));
+    evnt::event_manager ping_source;
+    evnt::event_manager ping_destination;
+    evnt::event_manager pong_source;
+    evnt::event_manager pong_destination;
+    evnt::spsc_channel<sized_event<32>> ping_channel(ping_source, 1024, policy);
+    evnt::spsc_channel<sized_event<32>> pong_channel(pong_source, 1024, policy);
+    ping_destination.connect<sized_event<32>>([&pong_source](sized_event<32>& event) { pong_source.emit(event); });
+    std::size_t number_of_pongs = 0;
+    pong_destination.connect<sized_event<32>>([&number_of_pongs](sized_event<32>&) { ++number_of_pongs; });
+
+    std::atomic_bool running = true;
+    std::thread echo([&]
+    {
+        while (running.load(std::memory_order_relaxed))
+        {
+            ping_channel.wait();
+            ping_channel.emit_received_events(ping_destination);
+        }
+    });
+
+    sized_event<32> event{};
+    for (auto _ : state)
+    {
+        ping_source.emit(event);
+        const std::size_t expected_number_of_pongs = number_of_pongs + 1;
+        while (number_of_pongs != expected_number_of_pongs)
+        {
+            pong_channel.wait();
+            pong_channel.emit_received_events(pong_destination);
+        }
+    }
+    running = false;
+    ping_channel.wake_up();
+    echo.join();
+    state.SetItemsProcessed(state.iterations());
+}
+}
+
+BENCHMARK(ping_pong)->ArgName("wait_policy")->Arg(0)->Arg(1)->UseRealTime();
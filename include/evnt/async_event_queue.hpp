@@ -1,7 +1,22 @@
 #pragma once
 
 #include "event_manager.hpp"
+#include "event_stats.hpp"
+#include "event_tracer.hpp"
+#include "priv/concurrent_type_table.hpp"
+#include "priv/event_ring.hpp"
+#include "priv/record_buffer.hpp"
+#include "priv/shared_batch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory_resource>
 #include <mutex>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 
@@ -9,21 +24,186 @@ namespace evnt
 {
 class async_event_queue
 {
+public:
+    // How producers publish events of a type:
+    //  - locked: events are appended to a vector under a mutex (default),
+    //  - lock_free: events are pushed on an atomic list with a single CAS, the consumer grabs the whole
+    //    list at sync(),
+    //  - ring: for trivially copyable events (locked otherwise), events are copied in a preallocated ring,
+    //    of twice the reserve() capacity (or default_ring_capacity), without lock nor allocation, and receivers
+    //    get them in place. When the ring is full, events overflow in the locked queue until a sync()
+    //    finds it empty.
+    // Choose the mode before producers start pushing events of this type.
+    enum class push_mode : std::uint8_t
+    {
+        locked,
+        lock_free,
+        ring
+    };
+
+    static constexpr std::size_t default_ring_capacity = 1024;
+
+    // In which order the events are emitted:
+    //  - by_type: type by type (see set_priority()), each type in push order,
+    //  - as_pushed: all types in push order. Events are stored in a single buffer and per-type settings
+    //    (push mode, capacity, coalescing, priority) do not apply.
+    enum class delivery_order : std::uint8_t
+    {
+        by_type,
+        as_pushed
+    };
+
+    // What a push does when the queue of its event type is full (see set_capacity()):
+    //  - block: the producer waits until the next sync(),
+    //  - drop_newest: the pushed event is dropped,
+    //  - drop_oldest: the oldest pending event is dropped,
+    //  - coalesce: the pushed event replaces the newest pending event.
+    enum class overflow_policy : std::uint8_t
+    {
+        block,
+        drop_newest,
+        drop_oldest,
+        coalesce
+    };
+
+private:
+    // What a push does when the queue of its event type is full with overflow_policy::block: wait for space,
+    // or return without pushing, on its first attempt (counted as a blocked push) or a next one.
+    enum class block_mode : std::uint8_t
+    {
+        wait,
+        try_first,
+        try_again
+    };
+
+public:
+    struct overflow_counters
+    {
+        std::size_t dropped_events = 0;
+        std::size_t blocked_pushes = 0;
+        std::size_t coalesced_events = 0;
+    };
+
 private:
     class async_event_queue_interface
     {
     public:
         virtual ~async_event_queue_interface();
-        virtual void emit(event_manager& evt_manager) = 0;
-        virtual void sync() = 0;
+        // With forward, the events may be moved to the event boxes of evt_manager (see event_manager::forward_events_).
+        virtual void emit(event_manager& evt_manager, bool forward) = 0;
+        // Returns the number of pushed events it consumed: the synchronized ones, and the dropped or coalesced ones.
+        virtual std::size_t sync() = 0;
+        virtual void collect_stats(event_type_stats& stats) const = 0;
+
+        inline int priority() const { return priority_.load(std::memory_order_relaxed); }
+        inline void set_priority(int priority) { priority_.store(priority, std::memory_order_relaxed); }
+
+    private:
+        std::atomic_int priority_ = 0;
+    };
+
+    // Deletes an object allocated from the memory resource of the queue.
+    template <class value_type>
+    struct resource_deleter
+    {
+        std::pmr::memory_resource* resource = nullptr;
+        void(*destroy)(std::pmr::memory_resource* resource, value_type* value) = nullptr;
+
+        inline void operator()(value_type* value) const { destroy(resource, value); }
     };
-    using async_event_queue_interface_uptr = std::unique_ptr<async_event_queue_interface>;
+    template <class value_type>
+    using resource_uptr = std::unique_ptr<value_type, resource_deleter<value_type>>;
+
+    // Allocates an object_type from resource, owned through its value_type base.
+    template <class value_type, class object_type, class... args_types>
+    static resource_uptr<value_type> new_resource_object_(std::pmr::memory_resource* resource, args_types&&... args)
+    {
+        std::pmr::polymorphic_allocator<> allocator(resource);
+        resource_deleter<value_type> deleter{ resource, [](std::pmr::memory_resource* resource, value_type* value)
+        {
+            std::pmr::polymorphic_allocator<>(resource).delete_object(static_cast<object_type*>(value));
+        } };
+        return resource_uptr<value_type>(allocator.new_object<object_type>(std::forward<args_types>(args)...), deleter);
+    }
 
     template <class event_type>
     class tmpl_async_event_queue : public async_event_queue_interface
     {
+        struct event_node
+        {
+            event_type event;
+            event_node* next;
+            // Set on one node of each push.
+            [[no_unique_address]] priv::optional_trace_flow_id<event_type> flow_id{};
+        };
+
+        // Index of the pending event of each key, for keyed coalescing.
+        class key_index_map
+        {
+        public:
+            virtual ~key_index_map() {}
+            // Returns the index of the pending event with the same key as event, or records and returns index.
+            virtual std::size_t try_emplace(const event_type& event, std::size_t index) = 0;
+            virtual void clear() = 0;
+        };
+
+        template <class key_function>
+        class tmpl_key_index_map : public key_index_map
+        {
+            using key_type = std::decay_t<std::invoke_result_t<key_function&, const event_type&>>;
+
+        public:
+            tmpl_key_index_map(key_function key, std::pmr::memory_resource* resource)
+                : key_(std::move(key)), indices_(resource)
+            {}
+
+            virtual std::size_t try_emplace(const event_type& event, std::size_t index) override
+            {
+                return indices_.try_emplace(key_(event), index).first->second;
+            }
+
+            virtual void clear() override
+            {
+                indices_.clear();
+            }
+
+        private:
+            key_function key_;
+            std::pmr::unordered_map<key_type, std::size_t> indices_;
+        };
+
     public:
-        virtual ~tmpl_async_event_queue() {}
+        explicit tmpl_async_event_queue(std::pmr::memory_resource* resource)
+            : events_(resource), pending_events_(resource), shared_batches_(resource), pending_shared_batches_(resource),
+              consumed_events_(resource), allocator_(resource)
+        {}
+
+        virtual ~tmpl_async_event_queue()
+        {
+            delete_nodes_(pushed_nodes_.load(std::memory_order_acquire));
+        }
+
+        void set_push_mode(push_mode mode)
+        {
+            if (mode == push_mode::ring)
+            {
+                if constexpr (!std::is_trivially_copyable_v<event_type>)
+                    mode = push_mode::locked;
+                else
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (!ring_)
+                    {
+                        // The events of the last sync() stay in the ring until the next one.
+                        std::size_t capacity = 2 * (pending_events_.capacity() ? pending_events_.capacity() : default_ring_capacity);
+                        using ring_type = priv::event_ring<event_type>;
+                        ring_ = new_resource_object_<ring_type, ring_type>(allocator_.resource(), capacity, allocator_.resource(),
+                                                                           tracing_enabled);
+                    }
+                }
+            }
+            push_mode_.store(mode, std::memory_order_release);
+        }
 
         void reserve(std::size_t capacity)
         {
@@ -31,37 +211,419 @@ private:
             pending_events_.reserve(capacity);
         }
 
-        const std::vector<event_type>& events() const { return events_; }
-        std::vector<event_type>& events() { return events_; }
+        void set_capacity(std::size_t capacity, overflow_policy policy)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                pending_events_.reserve(capacity);
+                capacity_ = capacity;
+                overflow_policy_ = policy;
+                key_indices_.reset();
+                push_mode_.store(push_mode::locked, std::memory_order_release);
+            }
+            not_full_.notify_all();
+        }
 
-        void push(event_type&& event)
+        template <class key_function>
+        void set_coalescing(key_function key)
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            pending_events_.push_back(std::move(event));
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                using key_map_type = tmpl_key_index_map<key_function>;
+                key_indices_ = new_resource_object_<key_index_map, key_map_type>(allocator_.resource(), std::move(key), allocator_.resource());
+                for (std::size_t index = 0; index < pending_events_.size(); ++index)
+                    key_indices_->try_emplace(pending_events_[index], index);
+                capacity_ = 0;
+                push_mode_.store(push_mode::locked, std::memory_order_release);
+            }
+            not_full_.notify_all();
         }
 
-        virtual void sync() override
+        overflow_counters counters() const
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            events_.swap(pending_events_);
-            pending_events_.clear();
-            pending_events_.reserve(events_.capacity());
+            return { dropped_event_count_.load(std::memory_order_relaxed), blocked_push_count_.load(std::memory_order_relaxed),
+                     coalesced_event_count_.load(std::memory_order_relaxed) };
         }
 
-        virtual void emit(event_manager& evt_manager) override
+        const std::pmr::vector<event_type>& events() const { return events_; }
+        std::pmr::vector<event_type>& events() { return events_; }
+
+        // Returns false if the event was not pushed, see block_mode.
+        bool push(event_type&& event, block_mode mode_if_full)
+        {
+            [[maybe_unused]] priv::trace_span span("push", typeid(event_type).name());
+            const push_mode mode = push_mode_.load(std::memory_order_acquire);
+            if (mode == push_mode::locked)
+            {
+                // Recorded once the event is accepted, before the consumer can sync it.
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (!push_locked_(lock, std::move(event), mode_if_full))
+                    return false;
+                record_locked_push_(1);
+                return true;
+            }
+
+            const std::uint64_t flow_id = record_push_(1);
+            if constexpr (std::is_trivially_copyable_v<event_type>)
+            {
+                if (mode == push_mode::ring && !ring_overflow_.load(std::memory_order_acquire)
+                    && ring_->try_push(std::span<const event_type>(&event, 1), flow_id))
+                    return true;
+            }
+            if (mode == push_mode::lock_free)
+            {
+                event_node* node = new_node_(std::move(event), pushed_nodes_.load(std::memory_order_relaxed));
+                if constexpr (tracing_enabled)
+                    node->flow_id = flow_id;
+                while (!pushed_nodes_.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+                    ;
+                return true;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            ring_overflow_.store(true, std::memory_order_relaxed);
+            push_locked_(lock, std::move(event), block_mode::wait);
+            if constexpr (tracing_enabled)
+                trace_flows_.add_pending(flow_id);
+            return true;
+        }
+
+        // Returns the number of events pushed, from the first one, see block_mode.
+        std::size_t push_events(std::span<const event_type> events, block_mode mode_if_full)
         {
-            evt_manager.emit(events());
+            [[maybe_unused]] priv::trace_span span("push", typeid(event_type).name());
+            const push_mode mode = push_mode_.load(std::memory_order_acquire);
+            if (mode == push_mode::locked)
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                const std::size_t number_of_events = push_events_locked_(lock, events, mode_if_full);
+                if (number_of_events != 0)
+                    record_locked_push_(number_of_events);
+                return number_of_events;
+            }
+
+            const std::uint64_t flow_id = record_push_(events.size());
+            if constexpr (std::is_trivially_copyable_v<event_type>)
+            {
+                if (mode == push_mode::ring && !ring_overflow_.load(std::memory_order_acquire) && ring_->try_push(events, flow_id))
+                    return events.size();
+            }
+            if (mode == push_mode::lock_free)
+            {
+                // Links the batch locally, then publishes it with a single CAS.
+                event_node* first_node = nullptr;
+                event_node* last_node = nullptr;
+                for (const event_type& event : events)
+                {
+                    first_node = new_node_(event, first_node);
+                    if (!last_node)
+                        last_node = first_node;
+                }
+                if (!first_node)
+                    return 0;
+                if constexpr (tracing_enabled)
+                    first_node->flow_id = flow_id;
+                last_node->next = pushed_nodes_.load(std::memory_order_relaxed);
+                while (!pushed_nodes_.compare_exchange_weak(last_node->next, first_node, std::memory_order_release, std::memory_order_relaxed))
+                    ;
+                return events.size();
+            }
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            ring_overflow_.store(true, std::memory_order_relaxed);
+            const std::size_t number_of_events = push_events_locked_(lock, events, block_mode::wait);
+            if constexpr (tracing_enabled)
+                trace_flows_.add_pending(flow_id);
+            return number_of_events;
+        }
+
+        // Keeps a reference on the batch, consumed at emit(). Bounded, coalescing and non-locked queues copy
+        // the events instead, and only release the batch once they copied all of them. Returns the number of
+        // events pushed.
+        std::size_t push_shared_events(std::shared_ptr<priv::shared_batch<event_type>> batch, block_mode mode_if_full)
+        {
+            if (push_mode_.load(std::memory_order_acquire) == push_mode::locked)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (capacity_ == 0 && !key_indices_)
+                {
+                    [[maybe_unused]] priv::trace_span span("push", typeid(event_type).name());
+                    record_locked_push_(batch->size());
+                    const std::size_t number_of_events = batch->size();
+                    pending_shared_batches_.push_back(shared_batch_entry{ pending_events_.size(), std::move(batch) });
+                    return number_of_events;
+                }
+            }
+            const std::size_t number_of_events = push_events(std::span<const event_type>(batch->events()), mode_if_full);
+            if (number_of_events == batch->size())
+                batch->release();
+            return number_of_events;
+        }
+
+        virtual std::size_t sync() override
+        {
+            [[maybe_unused]] priv::trace_span span("sync", typeid(event_type).name());
+            std::size_t dropped_event_count = 0;
+            std::size_t shared_event_count = 0;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                // Restores push order after drop_oldest overwrote the oldest events in place.
+                std::rotate(pending_events_.begin(), pending_events_.begin() + oldest_event_index_, pending_events_.end());
+                oldest_event_index_ = 0;
+                events_.swap(pending_events_);
+                pending_events_.clear();
+                pending_events_.reserve(events_.capacity());
+                shared_batches_.clear();
+                shared_batches_.swap(pending_shared_batches_);
+                for (const shared_batch_entry& entry : shared_batches_)
+                    shared_event_count += entry.batch->size();
+                std::swap(dropped_event_count, dropped_since_sync_);
+                if constexpr (tracing_enabled)
+                    trace_flows_.sync_pending();
+                if (key_indices_)
+                    key_indices_->clear();
+                // Overflowing events are emitted after the ring ones: the ring is used again once they all were.
+                if (events_.empty())
+                    ring_overflow_.store(false, std::memory_order_relaxed);
+            }
+            not_full_.notify_all();
+            sync_pushed_nodes_();
+            std::size_t ring_event_count = 0;
+            if (ring_)
+            {
+                ring_event_count = ring_->sync();
+                if constexpr (tracing_enabled)
+                    ring_->for_each_tag([this](std::uint64_t flow_id) { trace_flows_.add(flow_id); });
+            }
+            const std::size_t number_of_events = events_.size() + shared_event_count + ring_event_count + dropped_event_count;
+            if constexpr (stats_enabled)
+                stats_.record_sync(number_of_events);
+            return number_of_events;
+        }
+
+        virtual void emit(event_manager& evt_manager, bool forward) override
+        {
+            [[maybe_unused]] priv::trace_span span("deliver", typeid(event_type).name());
+            if constexpr (tracing_enabled)
+                trace_flows_.finish(typeid(event_type).name());
+            if (ring_)
+                ring_->for_each_span([&evt_manager](std::span<event_type> events) { evt_manager.emit(events); });
+            if (shared_batches_.empty())
+            {
+                if (forward)
+                    evt_manager.forward_events_(events_);
+                else
+                    evt_manager.emit(std::span<event_type>(events_));
+            }
+            else
+            {
+                // Shared batches were pushed between the events of events_. Only the queues of event boxes receive
+                // shared batches, and they always forward.
+                std::size_t first_index = 0;
+                for (shared_batch_entry& entry : shared_batches_)
+                {
+                    evt_manager.emit(std::span<event_type>(events_.data() + first_index, entry.position - first_index));
+                    first_index = entry.position;
+                    evt_manager.forward_events_(entry.batch->consume(consumed_events_));
+                }
+                shared_batches_.clear();
+                evt_manager.emit(std::span<event_type>(events_.data() + first_index, events_.size() - first_index));
+            }
+            if constexpr (stats_enabled)
+                stats_.record_delivery();
+        }
+
+        virtual void collect_stats(event_type_stats& stats) const override
+        {
+            if constexpr (stats_enabled)
+            {
+                stats.type_index = event_info::type_index<event_type>();
+                stats.type_name = typeid(event_type).name();
+                stats_.collect(stats);
+            }
         }
 
     private:
-        std::vector<event_type> events_;
-        std::vector<event_type> pending_events_;
+        struct shared_batch_entry
+        {
+            // Number of events of pending_events_ pushed before the batch.
+            std::size_t position;
+            std::shared_ptr<priv::shared_batch<event_type>> batch;
+        };
+
+        // Returns the id of the flow started for the pushed events, to carry with them (0 if none).
+        inline std::uint64_t record_push_(std::size_t number_of_events)
+        {
+            if constexpr (stats_enabled)
+                stats_.record_push(number_of_events);
+            if constexpr (tracing_enabled)
+                return priv::trace_flows::start(typeid(event_type).name());
+            else
+                return 0;
+        }
+
+        // Under the lock, once the events are in the pending events.
+        inline void record_locked_push_(std::size_t number_of_events)
+        {
+            [[maybe_unused]] const std::uint64_t flow_id = record_push_(number_of_events);
+            if constexpr (tracing_enabled)
+                trace_flows_.add_pending(flow_id);
+        }
+
+        std::size_t push_events_locked_(std::unique_lock<std::mutex>& lock, std::span<const event_type> events, block_mode mode_if_full)
+        {
+            if (!key_indices_ && (capacity_ == 0 || pending_events_.size() + events.size() <= capacity_))
+            {
+                pending_events_.insert(pending_events_.end(), events.begin(), events.end());
+                return events.size();
+            }
+            for (std::size_t index = 0; index < events.size(); ++index)
+                if (!push_locked_(lock, event_type(events[index]), mode_if_full))
+                    return index;
+            return events.size();
+        }
+
+        // Returns false if the queue is full with overflow_policy::block and mode_if_full is not block_mode::wait.
+        bool push_locked_(std::unique_lock<std::mutex>& lock, event_type&& event, block_mode mode_if_full)
+        {
+            if (key_indices_)
+            {
+                std::size_t index = key_indices_->try_emplace(event, pending_events_.size());
+                if (index < pending_events_.size())
+                {
+                    pending_events_[index] = std::move(event);
+                    coalesced_event_count_.fetch_add(1, std::memory_order_relaxed);
+                    ++dropped_since_sync_;
+                }
+                else
+                    pending_events_.push_back(std::move(event));
+                return true;
+            }
+
+            if (capacity_ == 0 || pending_events_.size() < capacity_)
+            {
+                pending_events_.push_back(std::move(event));
+                return true;
+            }
+
+            if (overflow_policy_ == overflow_policy::block)
+            {
+                if (mode_if_full != block_mode::try_again)
+                    blocked_push_count_.fetch_add(1, std::memory_order_relaxed);
+                if (mode_if_full != block_mode::wait)
+                    return false;
+                not_full_.wait(lock, [this] { return capacity_ == 0 || pending_events_.size() < capacity_; });
+                pending_events_.push_back(std::move(event));
+                return true;
+            }
+
+            ++dropped_since_sync_;
+            if (overflow_policy_ == overflow_policy::coalesce)
+            {
+                coalesced_event_count_.fetch_add(1, std::memory_order_relaxed);
+                pending_events_[(oldest_event_index_ + pending_events_.size() - 1) % pending_events_.size()] = std::move(event);
+                return true;
+            }
+
+            dropped_event_count_.fetch_add(1, std::memory_order_relaxed);
+            if (overflow_policy_ == overflow_policy::drop_oldest)
+            {
+                // pending_events_ is used as a ring until the next sync().
+                pending_events_[oldest_event_index_] = std::move(event);
+                oldest_event_index_ = (oldest_event_index_ + 1) % pending_events_.size();
+            }
+            return true;
+        }
+
+        // Appends the events pushed in lock_free mode, in push order, to the synchronized events.
+        void sync_pushed_nodes_()
+        {
+            event_node* node = pushed_nodes_.exchange(nullptr, std::memory_order_acquire);
+            event_node* first_node = nullptr;
+            std::size_t number_of_nodes = 0;
+            while (node)
+            {
+                event_node* next_node = node->next;
+                node->next = first_node;
+                first_node = node;
+                node = next_node;
+                ++number_of_nodes;
+            }
+
+            events_.reserve(events_.size() + number_of_nodes);
+            for (node = first_node; node; node = node->next)
+            {
+                events_.push_back(std::move(node->event));
+                if constexpr (tracing_enabled)
+                    trace_flows_.add(node->flow_id);
+            }
+            delete_nodes_(first_node);
+        }
+
+        // The event is constructed with the allocator of the queue, if it uses one.
+        template <class evt_type>
+        event_node* new_node_(evt_type&& event, event_node* next_node)
+        {
+            return allocator_.template new_object<event_node>(std::make_obj_using_allocator<event_type>(allocator_, std::forward<evt_type>(event)),
+                                                              next_node);
+        }
+
+        void delete_nodes_(event_node* node)
+        {
+            while (node)
+            {
+                event_node* next_node = node->next;
+                allocator_.delete_object(node);
+                node = next_node;
+            }
+        }
+
+    private:
+        std::pmr::vector<event_type> events_;
+        std::pmr::vector<event_type> pending_events_;
+        std::pmr::vector<shared_batch_entry> shared_batches_;
+        std::pmr::vector<shared_batch_entry> pending_shared_batches_;
+        // Copies of the shared batches of which this queue is not the last consumer.
+        std::pmr::vector<event_type> consumed_events_;
+        std::pmr::polymorphic_allocator<> allocator_;
+        // Only created in push_mode::ring, and never replaced afterwards.
+        resource_uptr<priv::event_ring<event_type>> ring_;
+        std::atomic_bool ring_overflow_ = false;
+        [[no_unique_address]] priv::optional_stats<priv::queue_stats, event_type> stats_;
+        [[no_unique_address]] priv::optional_trace_flows<event_type> trace_flows_;
         std::mutex mutex_;
+        std::condition_variable not_full_;
+        // Bounded queue (locked push mode only), capacity_ == 0 means unbounded.
+        std::size_t capacity_ = 0;
+        overflow_policy overflow_policy_ = overflow_policy::block;
+        std::size_t oldest_event_index_ = 0;
+        std::size_t dropped_since_sync_ = 0;
+        // Keyed coalescing, replaces the capacity.
+        resource_uptr<key_index_map> key_indices_;
+        std::atomic_size_t dropped_event_count_ = 0;
+        std::atomic_size_t blocked_push_count_ = 0;
+        std::atomic_size_t coalesced_event_count_ = 0;
+        std::atomic<event_node*> pushed_nodes_ = nullptr;
+        std::atomic<push_mode> push_mode_ = push_mode::locked;
     };
 
 public:
+    // The per-type queues, their queued events, lock-free nodes, rings and coalescing tables, and the table
+    // of the queues are allocated from resource, and events using an allocator (std::pmr::string members, ...)
+    // are copied with it. Producers and the consumer share resource, so it must be thread-safe
+    // (std::pmr::synchronized_pool_resource, ...) unless they all run on the same thread.
+    explicit async_event_queue(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : async_event_queue(delivery_order::by_type, resource)
+    {}
+
+    explicit async_event_queue(delivery_order order, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : resource_(resource), delivery_order_(order), pending_records_(resource), records_(resource), event_queues_(resource)
+    {}
+
+    inline delivery_order order() const { return delivery_order_; }
+
     template <class event_type>
-    inline const std::vector<event_type>& events()
+    inline const std::pmr::vector<event_type>& events()
     {
         return get_or_create_event_queue_<event_type>().events();
     }
@@ -69,7 +631,14 @@ public:
     template <class event_type>
     inline void push(event_type&& event)
     {
-        get_or_create_event_queue_<event_type>().push(std::move(event));
+        push_<event_type>(std::move(event), block_mode::wait);
+    }
+
+    // Pushes a copy of events, synchronizing once for the whole batch.
+    template <class event_type>
+    inline void push_events(std::span<const event_type> events)
+    {
+        push_events_<event_type>(events, block_mode::wait);
     }
 
     template <class event_type>
@@ -78,30 +647,181 @@ public:
         get_or_create_event_queue_<event_type>().reserve(capacity);
     }
 
+    template <class event_type>
+    void set_push_mode(push_mode mode)
+    {
+        get_or_create_event_queue_<event_type>().set_push_mode(mode);
+    }
+
+    // Bounds the number of pending events of event_type to capacity (0: unbounded), and pre-sizes the queue
+    // so that pushes never reallocate. Bounded queues use the locked push mode. With overflow_policy::block,
+    // producers wait for the consumer to sync(): never push from the consumer thread to a full queue. Event managers
+    // wait for the queues of their event boxes outside their snapshot of the boxes, so the consumer may still
+    // connect or disconnect boxes meanwhile.
+    template <class event_type>
+    void set_capacity(std::size_t capacity, overflow_policy policy = overflow_policy::block)
+    {
+        get_or_create_event_queue_<event_type>().set_capacity(capacity, policy);
+    }
+
+    // Between two sync(), only the latest pushed event of event_type is kept.
+    template <class event_type>
+    void set_coalescing()
+    {
+        set_capacity<event_type>(1, overflow_policy::coalesce);
+    }
+
+    // Between two sync(), only the latest pushed event of each key is kept, at the position of the first
+    // event pushed with this key. key(const event_type&) returns a hashable key. Replaces the capacity of
+    // the queue, and uses the locked push mode.
+    template <class event_type, class key_function>
+    void set_coalescing(key_function key)
+    {
+        get_or_create_event_queue_<event_type>().set_coalescing(std::move(key));
+    }
+
+    template <class event_type>
+    overflow_counters counters()
+    {
+        return get_or_create_event_queue_<event_type>().counters();
+    }
+
+    // Events of types with a higher priority are emitted first (default: 0). Types with the same priority
+    // take turns being emitted first, from one sync_and_emit_events() pass to the next.
+    template <class event_type>
+    void set_priority(int priority)
+    {
+        get_or_create_event_queue_<event_type>().set_priority(priority);
+        emission_order_version_.fetch_add(1, std::memory_order_release);
+    }
+
+    // Statistics of the event types pushed at least once (empty unless stats_enabled).
+    std::vector<event_type_stats> stats() const;
+
     void sync();
     void emit_events(event_manager& evt_manager);
     void sync_and_emit_events(event_manager& evt_manager);
+    // Synchronizes and emits the events type by type, by decreasing priority, and stops once deadline
+    // is reached: the next call resumes with the remaining types before starting a new pass, so that
+    // the types of lower priority are not starved under load. No type is processed once deadline is
+    // reached. Returns whether the pass was completed. In as_pushed order, all the events are emitted.
+    bool sync_and_emit_events(event_manager& evt_manager, std::chrono::steady_clock::time_point deadline);
+    inline bool sync_and_emit_events(event_manager& evt_manager, std::chrono::steady_clock::duration time_budget)
+    {
+        return sync_and_emit_events(evt_manager, std::chrono::steady_clock::now() + time_budget);
+    }
+
+    // Number of events pushed and not synchronized yet (all event types), approximate while producers push.
+    inline std::size_t pending_event_count() const { return pending_event_count_.load(std::memory_order_relaxed); }
 
 private:
+    friend class event_box;
+
+    // Event managers push to event boxes without waiting, see event_manager::retry_blocked_pushes_().
     template <class event_type>
-    inline tmpl_async_event_queue<event_type>& get_or_create_event_queue_()
+    bool push_(event_type&& event, block_mode mode_if_full)
     {
-        std::size_t index = event_info::type_index<event_type>();
-        if (index >= event_queues_.size())
-            event_queues_.resize(index + 1);
+        pending_event_count_.fetch_add(1, std::memory_order_relaxed);
+        if (delivery_order_ == delivery_order::as_pushed)
+        {
+            std::lock_guard<std::mutex> lock(records_mutex_);
+            pending_records_.emplace<event_type>(event_record_type_v<event_type>, std::move(event));
+            return true;
+        }
+        if (get_or_create_event_queue_<event_type>().push(std::move(event), mode_if_full))
+            return true;
+        pending_event_count_.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
 
-        async_event_queue_interface_uptr& async_event_queue_uptr = event_queues_[index];
-        if (!async_event_queue_uptr)
+    template <class event_type>
+    std::size_t push_events_(std::span<const event_type> events, block_mode mode_if_full)
+    {
+        pending_event_count_.fetch_add(events.size(), std::memory_order_relaxed);
+        if (delivery_order_ == delivery_order::as_pushed)
         {
-            async_event_queue_interface_uptr n_queue = std::make_unique<tmpl_async_event_queue<event_type>>();
-            async_event_queue_uptr = std::move(n_queue);
+            std::lock_guard<std::mutex> lock(records_mutex_);
+            for (const event_type& event : events)
+                pending_records_.emplace<event_type>(event_record_type_v<event_type>, event);
+            return events.size();
         }
+        const std::size_t number_of_events = get_or_create_event_queue_<event_type>().push_events(events, mode_if_full);
+        pending_event_count_.fetch_sub(events.size() - number_of_events, std::memory_order_relaxed);
+        return number_of_events;
+    }
 
-        return *static_cast<tmpl_async_event_queue<event_type>*>(async_event_queue_uptr.get());
+    // Pushes the events of a batch shared with other queues (see priv::shared_batch). Returns the number of events
+    // pushed: the batch is released once they all were.
+    template <class event_type>
+    std::size_t push_shared_events_(std::shared_ptr<priv::shared_batch<event_type>> batch, block_mode mode_if_full)
+    {
+        const std::size_t batch_size = batch->size();
+        pending_event_count_.fetch_add(batch_size, std::memory_order_relaxed);
+        if (delivery_order_ == delivery_order::as_pushed)
+        {
+            {
+                std::lock_guard<std::mutex> lock(records_mutex_);
+                for (const event_type& event : batch->events())
+                    pending_records_.emplace<event_type>(event_record_type_v<event_type>, event);
+            }
+            batch->release();
+            return batch_size;
+        }
+        const std::size_t number_of_events = get_or_create_event_queue_<event_type>().push_shared_events(std::move(batch), mode_if_full);
+        pending_event_count_.fetch_sub(batch_size - number_of_events, std::memory_order_relaxed);
+        return number_of_events;
     }
 
+    // Safe to call from any thread, even while another thread creates the queue of another event type.
+    template <class event_type>
+    inline tmpl_async_event_queue<event_type>& get_or_create_event_queue_()
+    {
+        bool created = false;
+        async_event_queue_interface& event_queue = event_queues_.get_or_create(event_info::type_index<event_type>(), [this, &created]
+        {
+            created = true;
+            return new_resource_object_<async_event_queue_interface, tmpl_async_event_queue<event_type>>(resource_, resource_);
+        });
+        // Once the queue is in the table, so that a consumer seeing the new version also sees the queue.
+        if (created)
+            emission_order_version_.fetch_add(1, std::memory_order_release);
+        return static_cast<tmpl_async_event_queue<event_type>&>(event_queue);
+    }
+
+    // Queues sorted by decreasing priority, rebuilt by the consumer when a queue is created or a priority changes.
+    const std::vector<async_event_queue_interface*>& emission_order_();
+    void start_next_pass_();
+
+    // Returns the number of synchronized records.
+    std::size_t sync_records_();
+
+    // Records of event_type emit their event to the event manager given as context.
+    template <class event_type>
+    static constexpr priv::record_type event_record_type_v
+    {
+        [](void* evt_manager, void* event) { static_cast<event_manager*>(evt_manager)->emit(*static_cast<event_type*>(event)); },
+        [](void* event) { static_cast<event_type*>(event)->~event_type(); },
+        sizeof(event_type),
+        alignof(event_type)
+    };
+
 private:
-    std::vector<async_event_queue_interface_uptr> event_queues_;
+    std::pmr::memory_resource* resource_;
+    delivery_order delivery_order_;
+    // as_pushed order: events of all types, pushed and synchronized.
+    priv::record_buffer pending_records_;
+    priv::record_buffer records_;
+    std::mutex records_mutex_;
+    priv::concurrent_type_table<async_event_queue_interface, resource_deleter<async_event_queue_interface>> event_queues_;
+    std::atomic_size_t pending_event_count_ = 0;
+    // Set for the queue of an event box, which only emits its events through sync_and_emit_events(): the synchronized
+    // events are then forwarded to the child boxes instead of copied.
+    bool forward_synced_events_ = false;
+    std::atomic_size_t emission_order_version_ = 0;
+    std::size_t emission_order_cache_version_ = 0;
+    std::vector<async_event_queue_interface*> emission_order_cache_;
+    // Position in emission_order_cache_ of the next type of the current pass.
+    std::size_t next_emission_index_ = 0;
 };
 }
 
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace evnt
+{
+template <class signature>
+class delegate;
+
+// Type-erased callable similar to std::function, but callables of at most three pointers
+// (member function receivers bound to an object, lambdas capturing a few references, ...)
+// are stored inline, without any allocation.
+template <class R, class... Args>
+class delegate<R(Args...)>
+{
+    static constexpr std::size_t inline_size = 3 * sizeof(void*);
+    static constexpr std::size_t inline_alignment = alignof(void*);
+
+    enum class operation { copy, move, destroy };
+    using invoke_function = R(*)(void* storage, Args... args);
+    using manage_function = void(*)(operation op, void* storage, void* other_storage);
+
+    template <class callable>
+    static constexpr bool is_stored_inline_v = sizeof(callable) <= inline_size
+                                               && alignof(callable) <= inline_alignment
+                                               && std::is_nothrow_move_constructible_v<callable>;
+
+    template <class callable>
+    static constexpr bool is_trivial_v = is_stored_inline_v<callable>
+                                         && std::is_trivially_copyable_v<callable>
+                                         && std::is_trivially_destructible_v<callable>;
+
+public:
+    using result_type = R;
+
+    delegate() noexcept {}
+    delegate(std::nullptr_t) noexcept {}
+
+    template <class callable>
+    requires (!std::is_same_v<std::decay_t<callable>, delegate>) && std::is_invocable_r_v<R, std::decay_t<callable>&, Args...>
+    delegate(callable&& function)
+    {
+        using callable_type = std::decay_t<callable>;
+        if constexpr (std::is_pointer_v<callable_type> || std::is_member_pointer_v<callable_type>
+                      || std::is_same_v<callable_type, std::function<R(Args...)>>)
+        {
+            if (!function)
+                return;
+        }
+        if constexpr (is_stored_inline_v<callable_type>)
+        {
+            ::new (static_cast<void*>(&storage_)) callable_type(std::forward<callable>(function));
+            invoke_ = &invoke_inline_<callable_type>;
+            if constexpr (!is_trivial_v<callable_type>)
+                manage_ = &manage_inline_<callable_type>;
+        }
+        else
+        {
+            *reinterpret_cast<callable_type**>(&storage_) = new callable_type(std::forward<callable>(function));
+            invoke_ = &invoke_heap_<callable_type>;
+            manage_ = &manage_heap_<callable_type>;
+        }
+    }
+
+    // Binds a member function known at compile time to an object. Only the object address
+    // is stored, and the call to method is direct, so it can be inlined in the thunk.
+    template <auto method, class object_type>
+    inline static delegate bind(object_type& object)
+    {
+        delegate result;
+        *reinterpret_cast<object_type**>(&result.storage_) = &object;
+        result.invoke_ = [](void* storage, Args... args) -> R
+        {
+            return std::invoke(method, **static_cast<object_type**>(storage), std::forward<Args>(args)...);
+        };
+        return result;
+    }
+
+    delegate(const delegate& other)
+        : invoke_(other.invoke_), manage_(other.manage_)
+    {
+        if (manage_)
+            manage_(operation::copy, &storage_, &other.storage_);
+        else
+            std::memcpy(&storage_, &other.storage_, inline_size);
+    }
+
+    delegate(delegate&& other) noexcept
+        : invoke_(other.invoke_), manage_(other.manage_)
+    {
+        if (manage_)
+            manage_(operation::move, &storage_, &other.storage_);
+        else
+            std::memcpy(&storage_, &other.storage_, inline_size);
+        other.reset_();
+    }
+
+    ~delegate()
+    {
+        if (manage_)
+            manage_(operation::destroy, &storage_, nullptr);
+    }
+
+    delegate& operator=(const delegate& other)
+    {
+        if (this != &other)
+        {
+            delegate copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    delegate& operator=(delegate&& other) noexcept
+    {
+        if (this != &other)
+        {
+            this->~delegate();
+            ::new (static_cast<void*>(this)) delegate(std::move(other));
+        }
+        return *this;
+    }
+
+    delegate& operator=(std::nullptr_t) noexcept
+    {
+        this->~delegate();
+        reset_();
+        return *this;
+    }
+
+    inline R operator()(Args... args) const
+    {
+        return invoke_(&storage_, std::forward<Args>(args)...);
+    }
+
+    inline explicit operator bool() const noexcept { return invoke_ != nullptr; }
+    inline friend bool operator==(const delegate& function, std::nullptr_t) noexcept { return !function; }
+
+private:
+    inline void reset_() noexcept
+    {
+        invoke_ = nullptr;
+        manage_ = nullptr;
+    }
+
+    template <class callable>
+    static R invoke_inline_(void* storage, Args... args)
+    {
+        return std::invoke(*static_cast<callable*>(storage), std::forward<Args>(args)...);
+    }
+
+    template <class callable>
+    static R invoke_heap_(void* storage, Args... args)
+    {
+        return std::invoke(**static_cast<callable**>(storage), std::forward<Args>(args)...);
+    }
+
+    template <class callable>
+    static void manage_inline_(operation op, void* storage, void* other_storage)
+    {
+        switch (op)
+        {
+        case operation::copy:
+            ::new (storage) callable(*static_cast<const callable*>(other_storage));
+            break;
+        case operation::move:
+            ::new (storage) callable(std::move(*static_cast<callable*>(other_storage)));
+            static_cast<callable*>(other_storage)->~callable();
+            break;
+        case operation::destroy:
+            static_cast<callable*>(storage)->~callable();
+            break;
+        }
+    }
+
+    template <class callable>
+    static void manage_heap_(operation op, void* storage, void* other_storage)
+    {
+        switch (op)
+        {
+        case operation::copy:
+            *static_cast<callable**>(storage) = new callable(**static_cast<const callable* const*>(other_storage));
+            break;
+        case operation::move:
+            *static_cast<callable**>(storage) = *static_cast<callable**>(other_storage);
+            break;
+        case operation::destroy:
+            delete *static_cast<callable**>(storage);
+            break;
+        }
+    }
+
+private:
+    alignas(inline_alignment) mutable std::byte storage_[inline_size];
+    invoke_function invoke_ = nullptr;
+    manage_function manage_ = nullptr;
+};
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "event_manager.hpp"
+#include <coroutine>
+
+namespace evnt
+{
+// Awaitable returned by event_manager::next<event_type>() and event_box::next<event_type>():
+// co_await suspends the coroutine until the next event of event_type is emitted and returns a copy of it.
+// The coroutine is resumed inside the emission, on the emitting thread, and the awaiter is connected
+// as a receiver bound to itself, so awaiting does not allocate a callable.
+template <class event_type>
+class event_awaiter
+{
+public:
+    explicit event_awaiter(event_manager& evt_manager)
+        : evt_manager_(evt_manager)
+    {}
+
+    event_awaiter(const event_awaiter&) = delete;
+    event_awaiter& operator=(const event_awaiter&) = delete;
+
+    // A coroutine destroyed while waiting stops waiting.
+    ~event_awaiter()
+    {
+        if (connection_)
+            evt_manager_.disconnect<event_type>(connection_);
+    }
+
+    inline bool await_ready() const noexcept { return false; }
+
+    inline void await_suspend(std::coroutine_handle<> coroutine)
+    {
+        using receiver_function = event_manager::receiver_function<event_type>;
+        coroutine_ = coroutine;
+        connection_ = evt_manager_.connect<event_type>(receiver_function::template bind<&event_awaiter::receive_>(*this),
+                                                       dispatch_order::ordered);
+        emission_count_ = evt_manager_.emission_count_<event_type>();
+    }
+
+    inline event_type await_resume()
+    {
+        assert(event_);
+        return *event_;
+    }
+
+private:
+    void receive_(event_type& event)
+    {
+        // Receivers connected during an emission are invoked by it: the event being emitted is not the next one.
+        if (evt_manager_.emission_count_<event_type>() == emission_count_)
+            return;
+        evt_manager_.disconnect<event_type>(connection_);
+        connection_ = 0;
+        // await_resume() runs inside resume(), while the event is still alive. This awaiter may be destroyed
+        // once the coroutine resumed.
+        event_ = &event;
+        coroutine_.resume();
+    }
+
+private:
+    event_manager& evt_manager_;
+    std::coroutine_handle<> coroutine_;
+    std::size_t connection_ = 0;
+    std::uint64_t emission_count_ = 0;
+    event_type* event_ = nullptr;
+};
+
+template <class event_type>
+inline event_awaiter<event_type> event_manager::next()
+{
+    return event_awaiter<event_type>(*this);
+}
+}
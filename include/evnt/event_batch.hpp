@@ -0,0 +1,116 @@
+#pragma once
+
+#include "event_manager.hpp"
+#include <memory_resource>
+#include <span>
+
+namespace evnt
+{
+// Producer-side staging of the events emitted to an event_manager, for a single thread.
+// The receivers of the event manager are invoked immediately, but the events for the connected event boxes
+// are kept in the batch until flush() or the destruction of the batch: each run of consecutive events of
+// a type is then pushed to each subscribed box in one operation, instead of one per event.
+// Events reach the boxes in emission order, so as_pushed boxes keep their order across event types.
+class event_batch
+{
+public:
+    // Staged events are allocated from resource, and their storage is reused after each flush().
+    explicit event_batch(event_manager& evt_manager, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    ~event_batch();
+    event_batch(const event_batch&) = delete;
+    event_batch& operator=(const event_batch&) = delete;
+
+    template <class event_type>
+    inline void emit(event_type& event)
+    {
+        if (event_manager::event_signal<event_type>* e_signal = event_manager_.find_event_signal_<event_type>())
+            e_signal->emit(event);
+        if (!event_manager_.dispatchers_.empty())
+            stage_<event_type>(event);
+    }
+
+    template <class event_type>
+    inline void emit(event_type&& event)
+    {
+        event_type evt = std::move(event);
+        if (event_manager::event_signal<event_type>* e_signal = event_manager_.find_event_signal_<event_type>())
+            e_signal->emit(evt);
+        if (!event_manager_.dispatchers_.empty())
+            stage_<event_type>(std::move(evt));
+    }
+
+    // Pushes the staged events to the event boxes connected to the event manager.
+    void flush();
+
+    inline std::size_t staged_event_count() const { return staged_event_count_; }
+
+private:
+    class staged_events_interface
+    {
+    public:
+        virtual void destroy(std::pmr::memory_resource* resource) = 0;
+        // Pushes the next count staged events.
+        virtual void flush(event_manager& evt_manager, std::size_t count) = 0;
+        virtual void clear() = 0;
+    };
+
+    template <class event_type>
+    class staged_events : public staged_events_interface
+    {
+    public:
+        explicit staged_events(std::pmr::memory_resource* resource)
+            : events(resource)
+        {}
+
+        virtual void flush(event_manager& evt_manager, std::size_t count) override
+        {
+            evt_manager.emit_batch_to_dispatchers_(std::span<const event_type>(events.data() + flushed_count, count));
+            flushed_count += count;
+        }
+
+        virtual void destroy(std::pmr::memory_resource* resource) override
+        {
+            std::pmr::polymorphic_allocator<>(resource).delete_object(this);
+        }
+
+        virtual void clear() override
+        {
+            events.clear();
+            flushed_count = 0;
+        }
+
+        std::pmr::vector<event_type> events;
+        std::size_t flushed_count = 0;
+    };
+
+    // Consecutive events of a type.
+    struct run
+    {
+        staged_events_interface* events;
+        std::size_t count;
+    };
+
+    template <class event_type, class value_type>
+    void stage_(value_type&& event)
+    {
+        std::size_t index = event_info::type_index<event_type>();
+        if (index >= staged_events_.size())
+            staged_events_.resize(index + 1);
+        staged_events_interface*& events = staged_events_[index];
+        if (!events)
+            events = std::pmr::polymorphic_allocator<>(resource_).new_object<staged_events<event_type>>(resource_);
+        if (runs_.empty() || runs_.back().events != events)
+            runs_.push_back(run{ events, 0 });
+        static_cast<staged_events<event_type>*>(events)->events.push_back(std::forward<value_type>(event));
+        ++runs_.back().count;
+        ++staged_event_count_;
+    }
+
+private:
+    event_manager& event_manager_;
+    std::pmr::memory_resource* resource_;
+    std::pmr::vector<staged_events_interface*> staged_events_;
+    std::pmr::vector<run> runs_;
+    std::size_t staged_event_count_ = 0;
+};
+}
@@ -1,24 +1,41 @@
 #pragma once
 
 #include "async_event_queue.hpp"
+#include "event_awaiter.hpp"
 
 namespace evnt
 {
 class event_box
 {
 public:
+    // Received events and the tables of the box are allocated from resource (see async_event_queue).
+    explicit event_box(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    // With async_event_queue::delivery_order::as_pushed, received events are emitted in the order they were
+    // received, whatever their types.
+    explicit event_box(async_event_queue::delivery_order order, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     ~event_box();
 
     template <class event_type, class receiver_type>
     inline void connect(receiver_type& listener)
     {
+        subscribe<event_type>();
         event_manager_.connect<event_type>(listener);
     }
 
     template <class event_type>
-    inline void connect(event_manager::receiver_function<event_type> listener)
+    inline std::size_t connect(event_manager::receiver_function<event_type> listener)
     {
-        event_manager_.connect<event_type>(std::move(listener));
+        subscribe<event_type>();
+        return event_manager_.connect<event_type>(std::move(listener));
+    }
+
+    // The parent event manager only pushes to this box the event types it subscribed to.
+    // Connecting a receiver subscribes to its event type, subscribe() lets the box queue events
+    // of a type before any receiver is connected.
+    template <class event_type>
+    inline void subscribe()
+    {
+        subscribe_(event_info::type_index<event_type>());
     }
 
     template <class event_type>
@@ -27,24 +44,107 @@ public:
         event_manager_.disconnect<event_type>(connection);
     }
 
+    // Connects child as a box of this box: the events received by this box are forwarded to child when this box
+    // emits them. This box subscribes to the event types child subscribes to, so trees of boxes only route the
+    // subscribed types. A batch forwarded to several boxes is shared: it is copied by each box when it emits it,
+    // except by the last one which uses it in place. The boxes of a tree should use memory resources which
+    // outlive the whole tree.
+    void connect(event_box& child);
+    void disconnect(event_box& child);
+
+    // Returns an awaitable on the next event of event_type received by this box: the coroutine is resumed
+    // inside emit_received_events(), on the thread draining the box.
+    template <class event_type>
+    inline event_awaiter<event_type> next()
+    {
+        subscribe<event_type>();
+        return event_manager_.next<event_type>();
+    }
+
+    template <class event_type>
+    inline void set_push_mode(async_event_queue::push_mode mode)
+    {
+        event_queue_.set_push_mode<event_type>(mode);
+    }
+
+    template <class event_type>
+    inline void set_capacity(std::size_t capacity, async_event_queue::overflow_policy policy = async_event_queue::overflow_policy::block)
+    {
+        event_queue_.set_capacity<event_type>(capacity, policy);
+    }
+
+    template <class event_type>
+    inline void set_coalescing()
+    {
+        event_queue_.set_coalescing<event_type>();
+    }
+
+    template <class event_type, class key_function>
+    inline void set_coalescing(key_function key)
+    {
+        event_queue_.set_coalescing<event_type>(std::move(key));
+    }
+
+    template <class event_type>
+    inline async_event_queue::overflow_counters counters()
+    {
+        return event_queue_.counters<event_type>();
+    }
+
+    template <class event_type>
+    inline void set_priority(int priority)
+    {
+        event_queue_.set_priority<event_type>(priority);
+    }
+
     void emit_received_events();
+    // Emits the received events by decreasing type priority until deadline, see async_event_queue::sync_and_emit_events().
+    bool emit_received_events(std::chrono::steady_clock::time_point deadline);
+
+    inline std::size_t pending_event_count() const { return event_queue_.pending_event_count(); }
+
+    // Statistics of the received event types: queueing, and emission to the receivers of the box
+    // (empty unless stats_enabled).
+    std::vector<event_type_stats> stats();
 
 private:
     friend class event_manager;
 
     void set_parent_event_manager(event_manager& evt_manager);
     void set_parent_event_manager(std::nullptr_t);
+    void subscribe_(std::size_t event_type_index);
+    std::vector<std::size_t> subscribed_event_types_();
 
+    // Event managers push without waiting for space in a full queue: they return whether, or how many, events
+    // were pushed, and the next attempts of a push pass retry = true.
     template <class event_type>
-    inline void push_event(event_type& event)
+    inline bool push_event(event_type& event, bool retry = false)
+    {
+        return event_queue_.push_<event_type>(event_type(event), retry_mode_(retry));
+    }
+
+    template <class event_type>
+    inline std::size_t push_events(std::span<const event_type> events, bool retry = false)
+    {
+        return event_queue_.push_events_<event_type>(events, retry_mode_(retry));
+    }
+
+    template <class event_type>
+    inline std::size_t push_shared_events_(std::shared_ptr<priv::shared_batch<event_type>> batch)
+    {
+        return event_queue_.push_shared_events_<event_type>(std::move(batch), async_event_queue::block_mode::try_first);
+    }
+
+    inline static async_event_queue::block_mode retry_mode_(bool retry)
     {
-        event_queue_.push(event_type(event));
+        return retry ? async_event_queue::block_mode::try_again : async_event_queue::block_mode::try_first;
     }
 
 private:
     event_manager* parent_event_manager_ = nullptr;
     async_event_queue event_queue_;
     event_manager event_manager_;
+    std::vector<std::size_t> event_type_indices_;
     std::mutex mutex_;
 };
 }
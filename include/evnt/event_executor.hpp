@@ -0,0 +1,64 @@
+#pragma once
+
+#include "event_box.hpp"
+#include "priv/snapshot_ptr.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace evnt
+{
+// Thread pool which drains a set of event boxes: each worker processes the boxes assigned to it
+// and, when it has nothing to do, steals the box with the deepest backlog.
+// A box is never processed by two threads at the same time.
+class event_executor
+{
+public:
+    explicit event_executor(std::size_t number_of_threads = std::thread::hardware_concurrency(),
+                            std::chrono::microseconds idle_wait_duration = std::chrono::milliseconds(1));
+    ~event_executor();
+    event_executor(const event_executor&) = delete;
+    event_executor& operator=(const event_executor&) = delete;
+
+    void add(event_box& evt_box);
+    // Once remove() returns, evt_box is not processed anymore and can be destroyed.
+    void remove(event_box& evt_box);
+
+    // Wakes up idle workers (they also check their boxes every idle_wait_duration).
+    void notify();
+
+    inline std::size_t number_of_threads() const { return workers_.size(); }
+
+private:
+    struct box_entry
+    {
+        event_box* evt_box;
+        std::size_t worker_index;
+        std::atomic_bool busy = false;
+        std::atomic_bool removed = false;
+    };
+    using box_entry_sptr = std::shared_ptr<box_entry>;
+    using box_entry_list = std::vector<box_entry_sptr>;
+
+    void run_(std::size_t worker_index);
+    bool try_process_(box_entry& entry);
+    box_entry_sptr find_deepest_entry_();
+
+private:
+    // Published as a snapshot: workers read the boxes of the current entries only inside a read section,
+    // so once remove() replaced the list, no worker looks at the removed box anymore.
+    priv::snapshot_ptr<box_entry_list> entries_;
+    std::atomic_size_t entries_version_ = 0;
+    std::size_t next_worker_index_ = 0;
+    std::vector<std::thread> workers_;
+    std::chrono::microseconds idle_wait_duration_;
+    std::atomic_bool stop_ = false;
+    std::size_t notification_count_ = 0;
+    std::condition_variable condition_;
+    std::mutex mutex_;
+};
+}
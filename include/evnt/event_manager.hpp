@@ -2,11 +2,21 @@
 
 #include "event_listener.hpp"
 #include "event_info.hpp"
+#include "event_stats.hpp"
+#include "event_tracer.hpp"
+#include "shared_event.hpp"
 #include "signal.hpp"
+#include "thread_pool.hpp"
+#include "priv/snapshot_ptr.hpp"
 #include <memory>
+#include <memory_resource>
 #include <atomic>
+#include <cstdint>
 #include <functional>
+#include <limits>
+#include <span>
 #include <type_traits>
+#include <typeinfo>
 #include <utility>
 #include <mutex>
 #include <cassert>
@@ -15,6 +25,16 @@ namespace evnt
 {
 class event_box;
 
+template <class event_type>
+class event_awaiter;
+
+// Where a receiver is invoked when its event type is dispatched in parallel (see event_manager::set_parallel_dispatch).
+enum class dispatch_order : std::uint8_t
+{
+    any,     // on any thread of the pool, concurrently with the other receivers
+    ordered, // on the emitting thread, in connection order, before the other receivers
+};
+
 class event_manager
 {
 private:
@@ -22,71 +42,227 @@ private:
     {
     public:
         virtual ~event_signal_interface() {}
+        virtual event_type_stats stats() = 0;
+    };
+
+    // Event signals are allocated from the memory resource of the event manager.
+    struct event_signal_deleter
+    {
+        std::pmr::memory_resource* resource = nullptr;
+        void(*destroy)(std::pmr::memory_resource* resource, event_signal_interface* e_signal) = nullptr;
+
+        inline void operator()(event_signal_interface* e_signal) const { destroy(resource, e_signal); }
+    };
+    using event_signal_interface_uptr = std::unique_ptr<event_signal_interface, event_signal_deleter>;
+
+    // Listeners which define receive(std::span<event_type>) receive whole batches of events.
+    template <class evt_listener, class event_type>
+    static constexpr bool is_batch_listener_v = requires
+    {
+        static_cast<void(evt_listener::*)(std::span<event_type>)>(&evt_listener::receive);
     };
-    using event_signal_interface_uptr = std::unique_ptr<event_signal_interface>;
 
     template <class event_type>
     class event_signal : public event_signal_interface
     {
         using evt_signal = signal<void(event_type&)>;
+        using batch_signal = signal<void(std::span<event_type>)>;
+
+        // Connections of batch receivers are tagged, so that both signals share one connection space.
+        static constexpr std::size_t batch_connection_flag = std::size_t(1) << (std::numeric_limits<std::size_t>::digits - 1);
+        static constexpr std::size_t ordered_connection_flag = batch_connection_flag >> 1;
 
     public:
         using listener_function = typename evt_signal::CbFunction;
+        using batch_listener_function = typename batch_signal::CbFunction;
 
         virtual ~event_signal() {}
 
         template <class evt_listener>
-        void connect(evt_listener& listener)
+        void connect(evt_listener& listener, dispatch_order order)
         {
-            void(evt_listener::*receive)(event_type&) = &evt_listener::receive;
-            listener_function function = std::bind(receive, &listener, std::placeholders::_1);
-            std::size_t connection = signal_.connect(std::move(function));
+            std::size_t connection = 0;
+            if constexpr (is_batch_listener_v<evt_listener, event_type>)
+            {
+                using receive_method = void(evt_listener::*)(std::span<event_type>);
+                batch_listener_function function = batch_listener_function::template bind<static_cast<receive_method>(&evt_listener::receive)>(listener);
+                connection = batch_signal_.connect(std::move(function)) | batch_connection_flag;
+            }
+            else
+            {
+                using receive_method = void(evt_listener::*)(event_type&);
+                listener_function function = listener_function::template bind<static_cast<receive_method>(&evt_listener::receive)>(listener);
+                connection = connect(std::move(function), order);
+            }
             listener.as_listener(static_cast<const event_type*>(nullptr))->set_connection(connection);
         }
 
-        inline void connect(listener_function&& listener)
+        inline std::size_t connect(listener_function&& listener, dispatch_order order)
         {
-            signal_.connect(listener);
+            if (order == dispatch_order::ordered)
+                return ordered_signal_.connect(std::move(listener)) | ordered_connection_flag;
+            return signal_.connect(std::move(listener));
         }
 
         inline void disconnect(std::size_t connection)
         {
-            signal_.disconnect(connection);
+            if (connection & batch_connection_flag)
+                batch_signal_.disconnect(connection & ~batch_connection_flag);
+            else if (connection & ordered_connection_flag)
+                ordered_signal_.disconnect(connection & ~ordered_connection_flag);
+            else
+                signal_.disconnect(connection);
+        }
+
+        inline void set_thread_pool(thread_pool* pool)
+        {
+            thread_pool_ = pool;
         }
 
         inline void emit(event_type& event)
         {
-            signal_.emit(event);
+            [[maybe_unused]] priv::trace_span span("emit", typeid(event_type).name());
+            if constexpr (stats_enabled)
+            {
+                const auto start_time = std::chrono::steady_clock::now();
+                emit_(event);
+                stats_.record_emission(1, ordered_signal_.size() + signal_.size() + batch_signal_.size(),
+                                       std::chrono::steady_clock::now() - start_time);
+            }
+            else
+                emit_(event);
+        }
+
+        inline void emit(std::span<event_type> events)
+        {
+            [[maybe_unused]] priv::trace_span span("emit", typeid(event_type).name());
+            if constexpr (stats_enabled)
+            {
+                const auto start_time = std::chrono::steady_clock::now();
+                emit_(events);
+                stats_.record_emission(events.size(), events.size() * (ordered_signal_.size() + signal_.size()) + batch_signal_.size(),
+                                       std::chrono::steady_clock::now() - start_time);
+            }
+            else
+                emit_(events);
+        }
+
+        // Number of events emitted so far, counting the event being emitted.
+        inline std::uint64_t emission_count() const { return emission_count_; }
+
+        virtual event_type_stats stats() override
+        {
+            event_type_stats stats;
+            if constexpr (stats_enabled)
+            {
+                stats.type_index = event_info::type_index<event_type>();
+                stats.type_name = typeid(event_type).name();
+                stats.receivers = ordered_signal_.size() + signal_.size() + batch_signal_.size();
+                stats_.collect(stats);
+            }
+            return stats;
+        }
+
+    private:
+        inline void emit_(event_type& event)
+        {
+            ++emission_count_;
+            emit_signal_(ordered_signal_, event);
+            emit_unordered_(event);
+            emit_signal_(batch_signal_, std::span<event_type>(&event, 1));
+        }
+
+        inline void emit_(std::span<event_type> events)
+        {
+            for (event_type& event : events)
+            {
+                ++emission_count_;
+                emit_signal_(ordered_signal_, event);
+                emit_unordered_(event);
+            }
+            emit_signal_(batch_signal_, events);
+        }
+
+        inline void emit_unordered_(event_type& event)
+        {
+            if (thread_pool_ && signal_.size() > 1)
+            {
+                thread_pool* pool = thread_pool_;
+                signal_.emit_partitioned([pool](std::size_t count, auto&& invoke_range)
+                {
+                    pool->parallel_for(count, traced_receivers_(invoke_range));
+                }, event);
+            }
+            else
+                emit_signal_(signal_, event);
+        }
+
+        template <class signal_type, class argument_type>
+        inline static void emit_signal_(signal_type& signal, argument_type&& argument)
+        {
+            if (priv::tracing_active())
+                signal.emit_partitioned([](std::size_t count, auto&& invoke_range) { traced_receivers_(invoke_range)(0, count); },
+                                        argument);
+            else
+                signal.emit(argument);
+        }
+
+        // Invokes the receivers in [first, last), with a span per receiver while the tracer is active.
+        template <class range_function_type>
+        inline static auto traced_receivers_(range_function_type& invoke_range)
+        {
+            return [&invoke_range](std::size_t first, std::size_t last)
+            {
+                if (!priv::tracing_active())
+                    return invoke_range(first, last);
+                for (std::size_t index = first; index < last; ++index)
+                {
+                    priv::trace_span span("receiver", typeid(event_type).name());
+                    invoke_range(index, index + 1);
+                }
+            };
         }
 
     private:
          evt_signal signal_;
+         evt_signal ordered_signal_;
+         batch_signal batch_signal_;
+         thread_pool* thread_pool_ = nullptr;
+         std::uint64_t emission_count_ = 0;
+         [[no_unique_address]] priv::optional_stats<priv::emit_stats, event_type> stats_;
     };
 
 public:
     template <class event_type>
     using receiver_function = typename event_signal<event_type>::listener_function;
 
-    event_manager() {}
+    // The per event type tables and signals are allocated from resource.
+    explicit event_manager(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : event_signals_(resource)
+    {}
     ~event_manager();
     event_manager(const event_manager&) = delete;
     event_manager& operator=(const event_manager&) = delete;
 
     void reserve(std::size_t number_of_event_types);
 
+    // Statistics of the event types which have a signal (empty unless stats_enabled).
+    // Like connect(), not safe while another thread connects receivers of a new event type.
+    std::vector<event_type_stats> stats();
+
     // Connect:
 
     template <class event_type, class receiver_type>
-    inline void connect(receiver_type& listener)
+    inline void connect(receiver_type& listener, dispatch_order order = dispatch_order::any)
     {
-        get_or_create_event_signal_<event_type>().connect(listener);
+        get_or_create_event_signal_<event_type>().connect(listener, order);
         listener.set_event_manager(*this);
     }
 
     template <class event_type>
-    inline void connect(receiver_function<event_type> listener)
+    inline std::size_t connect(receiver_function<event_type> listener, dispatch_order order = dispatch_order::any)
     {
-        get_or_create_event_signal_<event_type>().connect(std::move(listener));
+        return get_or_create_event_signal_<event_type>().connect(std::move(listener), order);
     }
 
     void connect(event_box& dispatcher);
@@ -101,18 +277,38 @@ public:
 
     void disconnect(event_box& dispatcher);
 
+    // Await events:
+
+    // Returns an awaitable on the next event of event_type (see event_awaiter).
+    template <class event_type>
+    event_awaiter<event_type> next();
+
+    // Dispatch policy:
+
+    // Invokes the receivers of event_type on pool: the emitting thread takes part and emit() returns once
+    // every receiver returned. Receivers connected with dispatch_order::ordered, and batch receivers, are still
+    // invoked on the emitting thread. The other receivers must be independent: they may run concurrently,
+    // so they only read the event and do not connect or disconnect receivers of event_type.
+    template <class event_type>
+    inline void set_parallel_dispatch(thread_pool& pool)
+    {
+        get_or_create_event_signal_<event_type>().set_thread_pool(&pool);
+    }
+
+    template <class event_type>
+    inline void set_sequential_dispatch()
+    {
+        if (event_signal<event_type>* e_signal = find_event_signal_<event_type>())
+            e_signal->set_thread_pool(nullptr);
+    }
+
     // Emit events:
 
     template <class event_type>
     inline void emit(event_type& event)
     {
-        std::size_t index = event_info::type_index<event_type>();
-        if (index < event_signals_.size())
-        {
-            event_signal_interface_uptr& event_signal_uptr = event_signals_[index];
-            if (event_signal_uptr)
-                static_cast<event_signal<event_type>*>(event_signal_uptr.get())->emit(event);
-        }
+        if (event_signal<event_type>* e_signal = find_event_signal_<event_type>())
+            e_signal->emit(event);
         emit_to_dispatchers_(event);
     }
 
@@ -123,23 +319,48 @@ public:
         emit<event_type>(std::ref(evt));
     }
 
+    // Invokes the receivers of event_type, then emits the event as a shared_event<event_type>: the event
+    // is stored once and connected event boxes receive a handle on it instead of their own copy.
+    // Event boxes only receive the shared_event<event_type>, not the event_type.
+    template <class event_type>
+    inline void emit_shared(event_type&& event)
+    {
+        using value_type = std::remove_cvref_t<event_type>;
+        value_type evt = std::forward<event_type>(event);
+        if (event_signal<value_type>* e_signal = find_event_signal_<value_type>())
+            e_signal->emit(evt);
+        emit(make_shared_event<value_type>(std::move(evt)));
+    }
+
+    // Emits a batch of events: the signal is looked up once, every receiver is invoked over the batch
+    // (batch listeners once, with the whole span) and each subscribed event box appends the batch
+    // to its queue in one operation.
+    template <class event_type>
+    inline void emit(std::span<event_type> events)
+    {
+        if (events.empty())
+            return;
+        if (event_signal<event_type>* e_signal = find_event_signal_<event_type>())
+            e_signal->emit(events);
+        emit_batch_to_dispatchers_(std::span<const event_type>(events));
+    }
+
     template <class event_type>
     inline void emit(std::vector<event_type>& events)
+    {
+        emit(std::span<event_type>(events));
+    }
+
+private:
+    template <class event_type>
+    inline event_signal<event_type>* find_event_signal_()
     {
         std::size_t index = event_info::type_index<event_type>();
         if (index < event_signals_.size())
-        {
-            event_signal_interface_uptr& event_signal_uptr = event_signals_[index];
-            if (event_signal_uptr)
-            {
-                event_signal<event_type>* e_signal = static_cast<event_signal<event_type>*>(event_signal_uptr.get());
-                for (event_type& event : events)
-                    e_signal->emit(event);
-            }
-        }
+            return static_cast<event_signal<event_type>*>(event_signals_[index].get());
+        return nullptr;
     }
 
-private:
     template <class event_type>
     inline event_signal<event_type>& event_signal_()
     {
@@ -156,19 +377,85 @@ private:
         event_signal_interface_uptr& event_signal_uptr = event_signals_[index];
         if (!event_signal_uptr)
         {
-            event_signal_interface_uptr n_event = std::make_unique<event_signal<event_type>>();
-            event_signal_uptr = std::move(n_event);
+            std::pmr::polymorphic_allocator<> allocator = event_signals_.get_allocator();
+            event_signal_deleter deleter{ allocator.resource(), [](std::pmr::memory_resource* resource, event_signal_interface* e_signal)
+            {
+                std::pmr::polymorphic_allocator<>(resource).delete_object(static_cast<event_signal<event_type>*>(e_signal));
+            } };
+            event_signal_uptr = event_signal_interface_uptr(allocator.new_object<event_signal<event_type>>(), deleter);
         }
 
         return *static_cast<event_signal<event_type>*>(event_signal_uptr.get());
     }
 
+    template <class event_type>
+    inline std::uint64_t emission_count_()
+    {
+        return event_signal_<event_type>().emission_count();
+    }
+
     template <class event_type>
     void emit_to_dispatchers_(event_type& event);
 
+    template <class event_type>
+    void emit_batch_to_dispatchers_(std::span<const event_type> events);
+
+    // Emits events, then hands them over to the subscribed event boxes as one shared batch: events may be moved.
+    template <class event_type>
+    inline void forward_events_(std::pmr::vector<event_type>& events)
+    {
+        if (events.empty())
+            return;
+        if (event_signal<event_type>* e_signal = find_event_signal_<event_type>())
+            e_signal->emit(std::span<event_type>(events));
+        forward_batch_to_dispatchers_(events);
+    }
+
+    template <class event_type>
+    void forward_batch_to_dispatchers_(std::pmr::vector<event_type>& events);
+
+    // Box whose full queue (overflow_policy::block) accepted only part of the events pushed to it.
+    struct blocked_push
+    {
+        event_box* dispatcher;
+        std::size_t pushed_count;
+    };
+
+    // Pushes the rest of the events to the boxes of blocked_pushes with push(dispatcher, pushed_count), which
+    // returns the new pushed count, until they accepted number_of_events. Waits out of any read section of
+    // dispatchers_, so that the consumers of the boxes may connect or disconnect boxes meanwhile. Boxes which
+    // are disconnected meanwhile are skipped.
+    template <class push_function>
+    void retry_blocked_pushes_(std::size_t event_type_index, std::size_t number_of_events,
+                               std::vector<blocked_push>& blocked_pushes, push_function&& push);
+
+    friend class event_box;
+    friend class event_batch;
+    friend class async_event_queue;
+    template <class event_type>
+    friend class event_awaiter;
+
+    // Rebuilds the routes of the connected dispatchers, after dispatcher subscribed to a new event type.
+    void update_dispatcher_routes_(event_box& dispatcher);
+    // Subscribes the owner box, if any, to the event types of dispatcher.
+    void subscribe_owner_box_(event_box& dispatcher);
+    void publish_dispatchers_(std::vector<event_box*> event_boxs);
+
 private:
-    std::vector<event_signal_interface_uptr> event_signals_;
-    std::vector<event_box*> event_boxs_;
+    // Connected event boxes, published as an immutable snapshot: emitters read it without locking,
+    // connect(event_box&) and disconnect(event_box&) replace it under mutex_.
+    // routes[type index] lists the boxes which subscribed to the event type.
+    struct dispatcher_list
+    {
+        std::vector<event_box*> event_boxs;
+        std::vector<std::vector<event_box*>> routes;
+    };
+
+    std::pmr::vector<event_signal_interface_uptr> event_signals_;
+    priv::snapshot_ptr<dispatcher_list> dispatchers_;
+    // Event box whose received events are emitted by this event manager: it subscribes to the event types
+    // of the boxes connected to this manager.
+    event_box* owner_box_ = nullptr;
     std::mutex mutex_;
 };
 }
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace evnt
+{
+// Statistics are collected when EVNT_ENABLE_STATS is defined (CMake option evnt_ENABLE_STATS). Otherwise,
+// they take no space, no time, and stats() snapshots are empty.
+#ifdef EVNT_ENABLE_STATS
+inline constexpr bool stats_enabled = true;
+#else
+inline constexpr bool stats_enabled = false;
+#endif
+
+// Distribution of durations: bucket i counts the durations in [2^(i-1), 2^i) nanoseconds, bucket 0 the null ones.
+struct duration_histogram
+{
+    static constexpr std::size_t number_of_buckets = 40;
+
+    std::array<std::uint64_t, number_of_buckets> buckets{};
+    std::uint64_t count = 0;
+    std::uint64_t total_ns = 0;
+    std::uint64_t max_ns = 0;
+};
+
+// Snapshot of the statistics of an event type, see event_manager::stats(), async_event_queue::stats()
+// and event_box::stats().
+struct event_type_stats
+{
+    std::size_t type_index = 0;
+    const char* type_name = "";
+
+    // Emission (event_manager):
+    std::uint64_t emitted_events = 0;
+    std::uint64_t receiver_invocations = 0;
+    std::size_t receivers = 0;
+    // Time spent in the receivers, per emission (an event or a batch).
+    duration_histogram dispatch_time;
+
+    // Queueing (async_event_queue, by_type delivery order only):
+    std::uint64_t pushed_events = 0;
+    std::size_t max_queue_depth = 0;
+    // Time between the oldest push of each synchronized batch and its emission.
+    duration_histogram delivery_latency;
+};
+
+namespace priv
+{
+class atomic_duration_histogram
+{
+public:
+    void record(std::chrono::steady_clock::duration duration)
+    {
+        const std::uint64_t ns = std::max<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), 0);
+        const std::size_t bucket = std::min<std::size_t>(std::bit_width(ns), duration_histogram::number_of_buckets - 1);
+        buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+        total_ns_.fetch_add(ns, std::memory_order_relaxed);
+        std::uint64_t max_ns = max_ns_.load(std::memory_order_relaxed);
+        while (ns > max_ns && !max_ns_.compare_exchange_weak(max_ns, ns, std::memory_order_relaxed))
+            ;
+    }
+
+    duration_histogram snapshot() const
+    {
+        duration_histogram histogram;
+        for (std::size_t bucket = 0; bucket < duration_histogram::number_of_buckets; ++bucket)
+        {
+            histogram.buckets[bucket] = buckets_[bucket].load(std::memory_order_relaxed);
+            histogram.count += histogram.buckets[bucket];
+        }
+        histogram.total_ns = total_ns_.load(std::memory_order_relaxed);
+        histogram.max_ns = max_ns_.load(std::memory_order_relaxed);
+        return histogram;
+    }
+
+private:
+    std::array<std::atomic_uint64_t, duration_histogram::number_of_buckets> buckets_{};
+    std::atomic_uint64_t total_ns_ = 0;
+    std::atomic_uint64_t max_ns_ = 0;
+};
+
+// Counters of an event signal of an event_manager.
+class emit_stats
+{
+public:
+    inline void record_emission(std::size_t number_of_events, std::size_t number_of_invocations,
+                                std::chrono::steady_clock::duration duration)
+    {
+        emitted_events_.fetch_add(number_of_events, std::memory_order_relaxed);
+        receiver_invocations_.fetch_add(number_of_invocations, std::memory_order_relaxed);
+        dispatch_time_.record(duration);
+    }
+
+    void collect(event_type_stats& stats) const
+    {
+        stats.emitted_events = emitted_events_.load(std::memory_order_relaxed);
+        stats.receiver_invocations = receiver_invocations_.load(std::memory_order_relaxed);
+        stats.dispatch_time = dispatch_time_.snapshot();
+    }
+
+private:
+    std::atomic_uint64_t emitted_events_ = 0;
+    std::atomic_uint64_t receiver_invocations_ = 0;
+    atomic_duration_histogram dispatch_time_;
+};
+
+// Counters of the queue of an event type of an async_event_queue.
+class queue_stats
+{
+    using clock = std::chrono::steady_clock;
+
+public:
+    // Producers:
+    inline void record_push(std::size_t number_of_events)
+    {
+        pushed_events_.fetch_add(number_of_events, std::memory_order_relaxed);
+        const std::size_t depth = depth_.fetch_add(number_of_events, std::memory_order_relaxed) + number_of_events;
+        std::size_t max_depth = max_depth_.load(std::memory_order_relaxed);
+        while (depth > max_depth && !max_depth_.compare_exchange_weak(max_depth, depth, std::memory_order_relaxed))
+            ;
+        clock::rep no_push_time = 0;
+        if (oldest_push_time_.load(std::memory_order_relaxed) == 0)
+            oldest_push_time_.compare_exchange_strong(no_push_time, clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    // Consumer:
+    inline void record_sync(std::size_t number_of_events)
+    {
+        depth_.fetch_sub(number_of_events, std::memory_order_relaxed);
+        synced_push_time_ = oldest_push_time_.exchange(0, std::memory_order_relaxed);
+    }
+
+    inline void record_delivery()
+    {
+        if (synced_push_time_ != 0)
+            delivery_latency_.record(clock::now().time_since_epoch() - clock::duration(synced_push_time_));
+        synced_push_time_ = 0;
+    }
+
+    void collect(event_type_stats& stats) const
+    {
+        stats.pushed_events = pushed_events_.load(std::memory_order_relaxed);
+        stats.max_queue_depth = max_depth_.load(std::memory_order_relaxed);
+        stats.delivery_latency = delivery_latency_.snapshot();
+    }
+
+private:
+    std::atomic_uint64_t pushed_events_ = 0;
+    std::atomic_size_t depth_ = 0;
+    std::atomic_size_t max_depth_ = 0;
+    std::atomic<clock::rep> oldest_push_time_ = 0;
+    clock::rep synced_push_time_ = 0;
+    atomic_duration_histogram delivery_latency_;
+};
+
+// Placeholder of the statistics of an owner when stats are disabled. It is a template of the owner type
+// (the event type of a queue, ...) so that the member calls in the discarded if constexpr (stats_enabled)
+// statements of a template owner stay dependent, and are not checked against an empty type.
+template <class owner_type>
+struct no_stats
+{
+};
+
+template <class stats_type, class owner_type>
+using optional_stats = std::conditional_t<stats_enabled, stats_type, no_stats<owner_type>>;
+}
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace evnt
+{
+// Tracing hooks are compiled when EVNT_ENABLE_TRACING is defined (CMake option evnt_ENABLE_TRACING).
+// Otherwise, they take no space and no time, and traces are empty.
+#ifdef EVNT_ENABLE_TRACING
+inline constexpr bool tracing_enabled = true;
+#else
+inline constexpr bool tracing_enabled = false;
+#endif
+
+// Records spans of the event flow (emissions, receiver invocations, queue synchronizations and deliveries)
+// and the flows from the pushes of events to their deliveries, while started. Each thread appends its
+// records to its own lock-free buffer. The records are written in the Chrome trace event format, which
+// can be opened with Perfetto (ui.perfetto.dev) or chrome://tracing.
+class event_tracer
+{
+public:
+    // Starts recording. The records of a previous recording are discarded.
+    static void start();
+    static void stop();
+    inline static bool active() { return tracing_enabled && active_.load(std::memory_order_relaxed); }
+
+    // Writes the records of the current (or last) recording as Chrome trace event JSON. Returns false
+    // if the file cannot be written.
+    static bool write_chrome_trace(const std::filesystem::path& path);
+
+    // Number of records which did not fit in the per-thread buffers.
+    static std::uint64_t dropped_records();
+
+private:
+    inline static std::atomic_bool active_ = false;
+};
+
+namespace priv
+{
+enum class trace_phase : char
+{
+    span = 'X',
+    flow_start = 's',
+    flow_finish = 'f',
+};
+
+struct trace_record
+{
+    const char* name;
+    const char* type_name;
+    std::uint64_t timestamp_ns;
+    std::uint64_t duration_ns;
+    std::uint64_t flow_id;
+    trace_phase phase;
+};
+
+std::uint64_t trace_clock_now();
+std::uint64_t new_trace_flow_id();
+// Appends record to the buffer of the calling thread.
+void append_trace_record(const trace_record& record);
+
+inline bool tracing_active()
+{
+    if constexpr (tracing_enabled)
+        return event_tracer::active();
+    else
+        return false;
+}
+
+// Records a span from its construction to its destruction, if the tracer is active at its construction.
+class trace_span
+{
+public:
+    inline trace_span(const char* name, const char* type_name)
+    {
+        if constexpr (tracing_enabled)
+            if (event_tracer::active())
+            {
+                name_ = name;
+                type_name_ = type_name;
+                start_time_ = trace_clock_now();
+            }
+    }
+
+    inline ~trace_span()
+    {
+        if constexpr (tracing_enabled)
+            if (name_)
+                append_trace_record({ name_, type_name_, start_time_, trace_clock_now() - start_time_, 0, trace_phase::span });
+    }
+
+    trace_span(const trace_span&) = delete;
+    trace_span& operator=(const trace_span&) = delete;
+
+private:
+    const char* name_ = nullptr;
+    const char* type_name_ = nullptr;
+    std::uint64_t start_time_ = 0;
+};
+
+// Flows from the pushes of an event queue to the delivery of the events. Each push starts a flow and
+// carries its id with the pushed events (queue, node or ring cell), so that producers share no state:
+// the consumer collects the ids of the synced events and finishes their flows at delivery.
+class trace_flows
+{
+public:
+    // Producers, inside a span: returns the id of the new flow, 0 if the tracer is not active.
+    static std::uint64_t start(const char* type_name)
+    {
+        if (!event_tracer::active())
+            return 0;
+        const std::uint64_t flow_id = new_trace_flow_id();
+        append_trace_record({ "event", type_name, trace_clock_now(), 0, flow_id, trace_phase::flow_start });
+        return flow_id;
+    }
+
+    // Producers, under the lock of the queue which pushed the events in its pending events.
+    inline void add_pending(std::uint64_t flow_id)
+    {
+        if (flow_id != 0)
+            pending_flow_ids_.push_back(flow_id);
+    }
+
+    // Consumer, under the lock of the queue, when it synchronizes its pending events.
+    inline void sync_pending()
+    {
+        flow_ids_.clear();
+        flow_ids_.swap(pending_flow_ids_);
+    }
+
+    // Consumer, for the events synchronized without the lock of the queue.
+    inline void add(std::uint64_t flow_id)
+    {
+        if (flow_id != 0)
+            flow_ids_.push_back(flow_id);
+    }
+
+    // Consumer, inside a span:
+    void finish(const char* type_name)
+    {
+        if (event_tracer::active())
+        {
+            const std::uint64_t timestamp = trace_clock_now();
+            for (std::uint64_t flow_id : flow_ids_)
+                append_trace_record({ "event", type_name, timestamp, 0, flow_id, trace_phase::flow_finish });
+        }
+        flow_ids_.clear();
+    }
+
+private:
+    std::vector<std::uint64_t> pending_flow_ids_;
+    std::vector<std::uint64_t> flow_ids_;
+};
+
+// Placeholder of the flows and flow ids when tracing is disabled, a template of the owner type like no_stats.
+template <class owner_type>
+struct no_trace_flows
+{
+};
+
+template <class owner_type>
+using optional_trace_flows = std::conditional_t<tracing_enabled, trace_flows, no_trace_flows<owner_type>>;
+// Flow id carried with pushed events, empty unless tracing_enabled.
+template <class owner_type>
+using optional_trace_flow_id = std::conditional_t<tracing_enabled, std::uint64_t, no_trace_flows<owner_type>>;
+}
+}
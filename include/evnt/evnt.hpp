@@ -4,6 +4,14 @@
 #include "event_manager.hpp"
 #include "async_event_queue.hpp"
 #include "event_box.hpp"
+#include "event_awaiter.hpp"
+#include "event_batch.hpp"
+#include "event_executor.hpp"
+#include "spsc_channel.hpp"
+#include "static_event_manager.hpp"
+#include <algorithm>
+#include <thread>
+#include <vector>
 
 namespace evnt
 {
@@ -21,11 +29,115 @@ inline void event_listener_base::break_connection(std::size_t connection)
 template <class event_type>
 void event_manager::emit_to_dispatchers_(event_type& event)
 {
-    std::lock_guard lock(mutex_);
-    for (event_box* dispatcher : event_boxs_)
+    if (dispatchers_.empty())
+        return;
+
+    const std::size_t index = event_info::type_index<event_type>();
+    std::vector<blocked_push> blocked_pushes;
+    {
+        decltype(dispatchers_)::read_section dispatchers(dispatchers_);
+        const dispatcher_list* list = dispatchers.get();
+        if (list && index < list->routes.size())
+            for (event_box* dispatcher : list->routes[index])
+            {
+                assert(dispatcher);
+                if (!dispatcher->push_event<event_type>(event))
+                    blocked_pushes.push_back(blocked_push{ dispatcher, 0 });
+            }
+    }
+    if (!blocked_pushes.empty())
+        retry_blocked_pushes_(index, 1, blocked_pushes, [&event](event_box& dispatcher, std::size_t)
+        {
+            return dispatcher.push_event<event_type>(event, true) ? std::size_t(1) : std::size_t(0);
+        });
+}
+
+template <class event_type>
+void event_manager::emit_batch_to_dispatchers_(std::span<const event_type> events)
+{
+    if (dispatchers_.empty())
+        return;
+
+    const std::size_t index = event_info::type_index<event_type>();
+    std::vector<blocked_push> blocked_pushes;
+    {
+        decltype(dispatchers_)::read_section dispatchers(dispatchers_);
+        const dispatcher_list* list = dispatchers.get();
+        if (list && index < list->routes.size())
+            for (event_box* dispatcher : list->routes[index])
+            {
+                assert(dispatcher);
+                const std::size_t pushed_count = dispatcher->push_events<event_type>(events);
+                if (pushed_count < events.size())
+                    blocked_pushes.push_back(blocked_push{ dispatcher, pushed_count });
+            }
+    }
+    if (!blocked_pushes.empty())
+        retry_blocked_pushes_(index, events.size(), blocked_pushes, [events](event_box& dispatcher, std::size_t pushed_count)
+        {
+            return pushed_count + dispatcher.push_events<event_type>(events.subspan(pushed_count), true);
+        });
+}
+
+template <class event_type>
+void event_manager::forward_batch_to_dispatchers_(std::pmr::vector<event_type>& events)
+{
+    if (dispatchers_.empty())
+        return;
+
+    const std::size_t index = event_info::type_index<event_type>();
+    std::vector<blocked_push> blocked_pushes;
+    // Copy of the batch for the boxes which did not accept all of it: they release the batch meanwhile.
+    std::pmr::vector<event_type> blocked_events(events.get_allocator());
+    {
+        decltype(dispatchers_)::read_section dispatchers(dispatchers_);
+        const dispatcher_list* list = dispatchers.get();
+        if (!list || index >= list->routes.size() || list->routes[index].empty())
+            return;
+
+        const std::vector<event_box*>& route = list->routes[index];
+        std::pmr::polymorphic_allocator<> allocator(events.get_allocator().resource());
+        auto batch = std::allocate_shared<priv::shared_batch<event_type>>(allocator, std::move(events), route.size());
+        for (event_box* dispatcher : route)
+        {
+            assert(dispatcher);
+            const std::size_t pushed_count = dispatcher->push_shared_events_<event_type>(batch);
+            if (pushed_count < batch->size())
+            {
+                if (blocked_events.empty())
+                    blocked_events.assign(batch->events().begin(), batch->events().end());
+                batch->release();
+                blocked_pushes.push_back(blocked_push{ dispatcher, pushed_count });
+            }
+        }
+    }
+    if (!blocked_pushes.empty())
+        retry_blocked_pushes_(index, blocked_events.size(), blocked_pushes, [&blocked_events](event_box& dispatcher, std::size_t pushed_count)
+        {
+            std::span<const event_type> events(blocked_events);
+            return pushed_count + dispatcher.push_events<event_type>(events.subspan(pushed_count), true);
+        });
+}
+
+template <class push_function>
+void event_manager::retry_blocked_pushes_(std::size_t event_type_index, std::size_t number_of_events,
+                                          std::vector<blocked_push>& blocked_pushes, push_function&& push)
+{
+    while (!blocked_pushes.empty())
     {
-        assert(dispatcher);
-        dispatcher->push_event<event_type>(event);
+        std::this_thread::yield();
+        decltype(dispatchers_)::read_section dispatchers(dispatchers_);
+        const dispatcher_list* list = dispatchers.get();
+        std::erase_if(blocked_pushes, [&](blocked_push& b_push)
+        {
+            if (!list || event_type_index >= list->routes.size())
+                return true;
+            const std::vector<event_box*>& route = list->routes[event_type_index];
+            if (std::find(route.begin(), route.end(), b_push.dispatcher) == route.end())
+                return true;
+            b_push.pushed_count = push(*b_push.dispatcher, b_push.pushed_count);
+            return b_push.pushed_count == number_of_events;
+        });
     }
 }
 }
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace evnt::priv
+{
+// Table of owned objects indexed by event type index, which can be read and grown from any thread.
+// Elements live in segments which are never relocated: the first segment is stored inline (one acquire
+// load to find an element), the next ones are allocated from the memory resource on demand and double
+// in size each time. Each object is destroyed by the deleter it was created with.
+template <class value_type, class value_deleter = std::default_delete<value_type>>
+class concurrent_type_table
+{
+    static constexpr std::size_t first_segment_size = 32;
+    static constexpr std::size_t number_of_segments = 48;
+
+    struct element
+    {
+        std::atomic<value_type*> value{};
+        // Written by the thread which created the value, read by the destructor.
+        value_deleter deleter{};
+    };
+
+public:
+    using value_uptr = std::unique_ptr<value_type, value_deleter>;
+
+    explicit concurrent_type_table(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : allocator_(resource)
+    {}
+    concurrent_type_table(const concurrent_type_table&) = delete;
+    concurrent_type_table& operator=(const concurrent_type_table&) = delete;
+
+    ~concurrent_type_table()
+    {
+        destroy_values_(first_segment_.data(), first_segment_size);
+        for (std::size_t segment = 1; segment < number_of_segments; ++segment)
+            if (element* elements = segments_[segment].load(std::memory_order_acquire))
+            {
+                destroy_values_(elements, segment_size_(segment));
+                deallocate_segment_(elements, segment_size_(segment));
+            }
+    }
+
+    inline value_type* find(std::size_t index) const
+    {
+        if (index < first_segment_size)
+            return first_segment_[index].value.load(std::memory_order_acquire);
+
+        auto [segment, offset] = locate_(index);
+        const element* elements = segments_[segment].load(std::memory_order_acquire);
+        return elements ? elements[offset].value.load(std::memory_order_acquire) : nullptr;
+    }
+
+    // Returns the element at index, creating it with make_value() (which returns a value_uptr) if it does
+    // not exist yet. When several threads race to create it, only one value is kept.
+    template <class factory_type>
+    inline value_type& get_or_create(std::size_t index, factory_type&& make_value)
+    {
+        element& slot = element_(index);
+        value_type* value = slot.value.load(std::memory_order_acquire);
+        if (value)
+            return *value;
+
+        value_uptr n_value = make_value();
+        if (slot.value.compare_exchange_strong(value, n_value.get(), std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            slot.deleter = n_value.get_deleter();
+            return *n_value.release();
+        }
+        return *value;
+    }
+
+    // Calls function on every existing element, in index order.
+    template <class function_type>
+    void for_each(function_type&& function) const
+    {
+        for (const element& slot : first_segment_)
+            if (value_type* value = slot.value.load(std::memory_order_acquire))
+                function(*value);
+
+        for (std::size_t segment = 1; segment < number_of_segments; ++segment)
+        {
+            const element* elements = segments_[segment].load(std::memory_order_acquire);
+            if (!elements)
+                continue;
+            for (std::size_t offset = 0, size = segment_size_(segment); offset < size; ++offset)
+                if (value_type* value = elements[offset].value.load(std::memory_order_acquire))
+                    function(*value);
+        }
+    }
+
+private:
+    struct location
+    {
+        std::size_t segment;
+        std::size_t offset;
+    };
+
+    // Segment s (s > 0) holds indices [first_segment_size * (2^s - 1), first_segment_size * (2^(s+1) - 1)).
+    inline static location locate_(std::size_t index)
+    {
+        const std::size_t segment = std::bit_width(index / first_segment_size + 1) - 1;
+        return { segment, index - first_segment_size * ((std::size_t(1) << segment) - 1) };
+    }
+
+    inline static std::size_t segment_size_(std::size_t segment)
+    {
+        return first_segment_size << segment;
+    }
+
+    inline element& element_(std::size_t index)
+    {
+        if (index < first_segment_size)
+            return first_segment_[index];
+
+        auto [segment, offset] = locate_(index);
+        std::atomic<element*>& segment_ptr = segments_[segment];
+        element* elements = segment_ptr.load(std::memory_order_acquire);
+        if (!elements)
+        {
+            element* n_elements = allocator_.allocate_object<element>(segment_size_(segment));
+            std::uninitialized_value_construct_n(n_elements, segment_size_(segment));
+            if (segment_ptr.compare_exchange_strong(elements, n_elements, std::memory_order_acq_rel, std::memory_order_acquire))
+                elements = n_elements;
+            else
+                deallocate_segment_(n_elements, segment_size_(segment));
+        }
+        return elements[offset];
+    }
+
+    inline static void destroy_values_(element* elements, std::size_t size)
+    {
+        for (std::size_t offset = 0; offset < size; ++offset)
+            if (value_type* value = elements[offset].value.load(std::memory_order_acquire))
+                elements[offset].deleter(value);
+    }
+
+    inline void deallocate_segment_(element* elements, std::size_t size)
+    {
+        std::destroy_n(elements, size);
+        allocator_.deallocate_object(elements, size);
+    }
+
+private:
+    std::pmr::polymorphic_allocator<> allocator_;
+    std::array<element, first_segment_size> first_segment_{};
+    std::array<std::atomic<element*>, number_of_segments> segments_{};
+};
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <span>
+#include <thread>
+#include <type_traits>
+
+namespace evnt::priv
+{
+// Bounded multi-producer single-consumer ring of trivially copyable values (D. Vyukov's bounded queue).
+// Producers claim cells with a CAS on the enqueue position, copy values with memcpy and publish each
+// cell through its sequence number. The consumer reads the published values in place, and releases
+// them at its next sync(). With tags, each push also tags its first cell (the flow id of the push, ...).
+template <class value_type>
+class event_ring
+{
+public:
+    event_ring(std::size_t capacity, std::pmr::memory_resource* resource, bool with_tags = false)
+        : allocator_(resource), capacity_(std::bit_ceil(std::max<std::size_t>(capacity, 2)))
+    {
+        values_ = static_cast<value_type*>(allocator_.allocate_bytes(capacity_ * sizeof(value_type), alignof(value_type)));
+        sequences_ = allocator_.allocate_object<std::atomic_size_t>(capacity_);
+        for (std::size_t index = 0; index < capacity_; ++index)
+            ::new (static_cast<void*>(sequences_ + index)) std::atomic_size_t(index);
+        if (with_tags)
+            tags_ = allocator_.allocate_object<std::uint64_t>(capacity_);
+    }
+
+    event_ring(const event_ring&) = delete;
+    event_ring& operator=(const event_ring&) = delete;
+
+    ~event_ring()
+    {
+        if (tags_)
+            allocator_.deallocate_object(tags_, capacity_);
+        allocator_.deallocate_object(sequences_, capacity_);
+        allocator_.deallocate_bytes(values_, capacity_ * sizeof(value_type), alignof(value_type));
+    }
+
+    inline std::size_t capacity() const { return capacity_; }
+
+    // Pushes all values, or none if the ring has not enough free cells. tag is ignored without tags.
+    bool try_push(std::span<const value_type> values, std::uint64_t tag = 0)
+    {
+        static_assert(std::is_trivially_copyable_v<value_type>);
+        const std::size_t count = values.size();
+        if (count == 0)
+            return true;
+        if (count > capacity_)
+            return false;
+
+        // The consumer releases cells in order: if the last cell is free, so are the previous ones.
+        std::size_t position = enqueue_position_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            const std::size_t last_position = position + count - 1;
+            const std::size_t sequence = sequences_[last_position & mask_()].load(std::memory_order_acquire);
+            const std::ptrdiff_t difference = std::ptrdiff_t(sequence - last_position);
+            if (difference == 0)
+            {
+                if (enqueue_position_.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+                return false;
+            else
+                position = enqueue_position_.load(std::memory_order_relaxed);
+        }
+
+        const std::size_t first_index = position & mask_();
+        const std::size_t first_count = std::min(count, capacity_ - first_index);
+        std::memcpy(static_cast<void*>(values_ + first_index), values.data(), first_count * sizeof(value_type));
+        std::memcpy(static_cast<void*>(values_), values.data() + first_count, (count - first_count) * sizeof(value_type));
+        if (tags_)
+            for (std::size_t offset = 0; offset < count; ++offset)
+                tags_[(position + offset) & mask_()] = offset == 0 ? tag : 0;
+        for (std::size_t offset = 0; offset < count; ++offset)
+            sequences_[(position + offset) & mask_()].store(position + offset + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: releases the values of the previous sync() and returns the number of values pushed since,
+    // in push order. Waits for the producers which claimed cells to publish them.
+    std::size_t sync()
+    {
+        for (std::size_t offset = 0; offset < synced_count_; ++offset)
+            sequences_[(dequeue_position_ + offset) & mask_()].store(dequeue_position_ + offset + capacity_, std::memory_order_release);
+        dequeue_position_ += synced_count_;
+
+        synced_count_ = enqueue_position_.load(std::memory_order_acquire) - dequeue_position_;
+        for (std::size_t offset = 0; offset < synced_count_; ++offset)
+        {
+            const std::size_t position = dequeue_position_ + offset;
+            while (sequences_[position & mask_()].load(std::memory_order_acquire) != position + 1)
+                std::this_thread::yield();
+        }
+        return synced_count_;
+    }
+
+    // Consumer: calls function with the values of the last sync(), as one or two contiguous spans.
+    template <class function_type>
+    void for_each_span(function_type&& function)
+    {
+        const std::size_t first_index = dequeue_position_ & mask_();
+        const std::size_t first_count = std::min(synced_count_, capacity_ - first_index);
+        if (first_count)
+            function(std::span<value_type>(values_ + first_index, first_count));
+        if (synced_count_ > first_count)
+            function(std::span<value_type>(values_, synced_count_ - first_count));
+    }
+
+    // Consumer: calls function with the tag of each push of the last sync() (0 for the other cells).
+    template <class function_type>
+    void for_each_tag(function_type&& function) const
+    {
+        if (tags_)
+            for (std::size_t offset = 0; offset < synced_count_; ++offset)
+                function(tags_[(dequeue_position_ + offset) & mask_()]);
+    }
+
+private:
+    inline std::size_t mask_() const { return capacity_ - 1; }
+
+private:
+    std::pmr::polymorphic_allocator<> allocator_;
+    std::size_t capacity_;
+    value_type* values_ = nullptr;
+    std::atomic_size_t* sequences_ = nullptr;
+    std::uint64_t* tags_ = nullptr;
+    alignas(64) std::atomic_size_t enqueue_position_ = 0;
+    alignas(64) std::size_t dequeue_position_ = 0;
+    std::size_t synced_count_ = 0;
+};
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace evnt::priv
+{
+// Thunk table of a record type: how records of this type are invoked and destroyed.
+struct record_type
+{
+    void(*invoke)(void* context, void* value);
+    void(*destroy)(void* value);
+    std::uint32_t size;
+    std::uint32_t alignment;
+};
+
+// Append-only sequence of heterogeneous records. Each record is a pointer to the thunk table of its type,
+// followed by the value constructed in place. Values live in blocks which are never relocated, and
+// records are invoked in insertion order, with one indirect call per record.
+class record_buffer
+{
+    static constexpr std::size_t default_block_capacity = 16 * 1024;
+    static constexpr std::size_t block_alignment = 64;
+
+    struct alignas(block_alignment) block
+    {
+        block* next;
+        std::size_t size;
+        std::size_t capacity;
+
+        inline std::byte* data() { return reinterpret_cast<std::byte*>(this + 1); }
+    };
+
+    using record_header = const record_type*;
+
+public:
+    explicit record_buffer(std::pmr::memory_resource* resource)
+        : resource_(resource)
+    {}
+
+    record_buffer(const record_buffer&) = delete;
+    record_buffer& operator=(const record_buffer&) = delete;
+
+    ~record_buffer()
+    {
+        clear();
+        while (free_blocks_)
+        {
+            block* next_block = free_blocks_->next;
+            resource_->deallocate(free_blocks_, sizeof(block) + free_blocks_->capacity, block_alignment);
+            free_blocks_ = next_block;
+        }
+    }
+
+    inline std::size_t size() const { return size_; }
+    inline bool empty() const { return size_ == 0; }
+
+    // Both buffers must use the same memory resource.
+    void swap(record_buffer& other) noexcept
+    {
+        std::swap(first_block_, other.first_block_);
+        std::swap(last_block_, other.last_block_);
+        std::swap(free_blocks_, other.free_blocks_);
+        std::swap(size_, other.size_);
+    }
+
+    template <class value_type, class... args_types>
+    void emplace(const record_type& type, args_types&&... args)
+    {
+        static_assert(alignof(value_type) <= block_alignment);
+        std::size_t header_offset = last_block_ ? align_(last_block_->size, alignof(record_header)) : 0;
+        std::size_t value_offset = align_(header_offset + sizeof(record_header), alignof(value_type));
+        if (!last_block_ || value_offset + sizeof(value_type) > last_block_->capacity)
+        {
+            add_block_(sizeof(record_header) + alignof(value_type) + sizeof(value_type));
+            header_offset = 0;
+            value_offset = align_(sizeof(record_header), alignof(value_type));
+        }
+
+        std::byte* data = last_block_->data();
+        ::new (static_cast<void*>(data + value_offset)) value_type(std::forward<args_types>(args)...);
+        ::new (static_cast<void*>(data + header_offset)) record_header(&type);
+        last_block_->size = value_offset + sizeof(value_type);
+        ++size_;
+    }
+
+    // Calls invoke(context, value) of every record, in insertion order.
+    void invoke_all(void* context) const
+    {
+        for_each_record_([context](const record_type& type, void* value) { type.invoke(context, value); });
+    }
+
+    // Destroys the records, and keeps the blocks for the next ones.
+    void clear()
+    {
+        for_each_record_([](const record_type& type, void* value) { type.destroy(value); });
+        if (last_block_)
+        {
+            last_block_->next = free_blocks_;
+            free_blocks_ = first_block_;
+        }
+        for (block* free_block = free_blocks_; free_block; free_block = free_block->next)
+            free_block->size = 0;
+        first_block_ = last_block_ = nullptr;
+        size_ = 0;
+    }
+
+private:
+    inline static std::size_t align_(std::size_t offset, std::size_t alignment)
+    {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+
+    template <class function_type>
+    void for_each_record_(function_type&& function) const
+    {
+        for (block* current_block = first_block_; current_block; current_block = current_block->next)
+        {
+            std::byte* data = current_block->data();
+            for (std::size_t offset = 0; offset < current_block->size;)
+            {
+                const record_type& type = **std::launder(reinterpret_cast<record_header*>(data + offset));
+                std::size_t value_offset = align_(offset + sizeof(record_header), type.alignment);
+                function(type, static_cast<void*>(data + value_offset));
+                offset = align_(value_offset + type.size, alignof(record_header));
+            }
+        }
+    }
+
+    void add_block_(std::size_t min_capacity)
+    {
+        block* n_block = nullptr;
+        if (free_blocks_ && free_blocks_->capacity >= min_capacity)
+        {
+            n_block = free_blocks_;
+            free_blocks_ = free_blocks_->next;
+        }
+        else
+        {
+            std::size_t capacity = std::max(default_block_capacity, min_capacity);
+            n_block = ::new (resource_->allocate(sizeof(block) + capacity, block_alignment)) block{ nullptr, 0, capacity };
+        }
+        n_block->next = nullptr;
+        n_block->size = 0;
+        if (last_block_)
+            last_block_->next = n_block;
+        else
+            first_block_ = n_block;
+        last_block_ = n_block;
+    }
+
+private:
+    std::pmr::memory_resource* resource_;
+    block* first_block_ = nullptr;
+    block* last_block_ = nullptr;
+    block* free_blocks_ = nullptr;
+    std::size_t size_ = 0;
+};
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace evnt::priv
+{
+// Batch of events forwarded by an event manager to several event boxes, which consume it when they emit
+// their received events. Every consumer but the last one copies the events, the last one uses them in place
+// (it may modify or move them).
+template <class event_type>
+class shared_batch
+{
+public:
+    shared_batch(std::pmr::vector<event_type>&& events, std::size_t number_of_consumers)
+        : events_(std::move(events)), number_of_consumers_(number_of_consumers)
+    {}
+
+    inline std::size_t size() const { return events_.size(); }
+    inline const std::pmr::vector<event_type>& events() const { return events_; }
+
+    // Returns the events, in place if the caller is the last consumer, copied into buffer otherwise.
+    std::pmr::vector<event_type>& consume(std::pmr::vector<event_type>& buffer)
+    {
+        // The other consumers release the batch once they copied it.
+        if (number_of_consumers_.load(std::memory_order_acquire) == 1)
+            return events_;
+        buffer.assign(events_.begin(), events_.end());
+        release();
+        return buffer;
+    }
+
+    // For the consumers which copied the events by other means.
+    inline void release()
+    {
+        number_of_consumers_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+private:
+    std::pmr::vector<event_type> events_;
+    std::atomic_size_t number_of_consumers_;
+};
+}
@@ -4,7 +4,11 @@
 #include <unistd.h>
 #include <assert.h>
 #include <stdint.h>
+#include <algorithm>
+#include <deque>
 #include <functional>
+#include <iterator>
+#include <type_traits>
 #include <vector>
 
 namespace Simple {
@@ -12,7 +16,7 @@ namespace Simple {
 namespace Lib {
 
 /// ProtoSignal is the template implementation for callback list.
-template<typename,typename> class ProtoSignal;   // undefined
+template<typename,typename,typename> class ProtoSignal;   // undefined
 
 /// CollectorInvocation invokes signal handlers differently depending on return type.
 template<typename,typename> struct CollectorInvocation;
@@ -44,8 +48,8 @@ struct CollectorDefault<void> {
 /// CollectorInvocation specialisation for regular signals.
 template<class Collector, class R, class... Args>
 struct CollectorInvocation<Collector, R (Args...)> {
-  inline bool
-  invoke (Collector &collector, const std::function<R (Args...)> &cbf, Args... args)
+  template<class Function> inline bool
+  invoke (Collector &collector, const Function &cbf, Args... args)
   {
     return collector (cbf (args...));
   }
@@ -54,151 +58,205 @@ struct CollectorInvocation<Collector, R (Args...)> {
 /// CollectorInvocation specialisation for signals with void return type.
 template<class Collector, class... Args>
 struct CollectorInvocation<Collector, void (Args...)> {
-  inline bool
-  invoke (Collector &collector, const std::function<void (Args...)> &cbf, Args... args)
+  template<class Function> inline bool
+  invoke (Collector &collector, const Function &cbf, Args... args)
   {
     cbf (args...); return collector();
   }
 };
 
-/// ProtoSignal template specialised for the callback signature and collector.
-template<class Collector, class R, class... Args>
-class ProtoSignal<R (Args...), Collector> : private CollectorInvocation<Collector, R (Args...)> {
+/// ProtoSignal template specialised for the callback signature, collector and callback wrapper type.
+template<class Collector, class Function, class R, class... Args>
+class ProtoSignal<R (Args...), Collector, Function> : private CollectorInvocation<Collector, R (Args...)> {
 protected:
-  using CbFunction = std::function<R (Args...)>;
-  using Result = typename CbFunction::result_type;
+  using CbFunction = Function;
+  using Result = R;
   using CollectorResult = typename Collector::CollectorResult;
 private:
-  /// SignalLink implements a doubly-linked ring with ref-counted nodes containing the signal handlers.
-  struct SignalLink {
-    SignalLink *next, *prev;
+  static_assert (sizeof (size_t) >= 8, "connection IDs pack a 32 bits index and a generation in a size_t");
+  static constexpr uint32_t pending_position_flag = uint32_t (1) << 31;
+  static constexpr uint32_t free_position = ~uint32_t (0);
+  static constexpr size_t   generation_mask = (size_t (1) << 30) - 1;
+  /// SignalSlot is an entry of the contiguous callback array, a zero id marks a disconnected slot (tombstone).
+  struct SignalSlot {
     CbFunction  function;
-    int         ref_count;
-    explicit    SignalLink (const CbFunction &cbf) : next (nullptr), prev (nullptr), function (cbf), ref_count (1) {}
-    /*dtor*/   ~SignalLink ()           { assert (ref_count == 0); }
-    void        incref     ()           { ref_count += 1; assert (ref_count > 0); }
-    void        decref     ()           { ref_count -= 1; if (!ref_count) delete this; else assert (ref_count > 0); }
-    void
-    unlink ()
-    {
-      function = nullptr;
-      if (next)
-        next->prev = prev;
-      if (prev)
-        prev->next = next;
-      decref();
-      // leave intact ->next, ->prev for stale iterators
-    }
-    size_t
-    add_before (const CbFunction &cb)
-    {
-      SignalLink *link = new SignalLink (cb);
-      link->prev = prev; // link to last
-      link->next = this;
-      prev->next = link; // link from last
-      prev = link;
-      static_assert (sizeof (link) == sizeof (size_t), "sizeof size_t");
-      return size_t (link);
-    }
-    bool
-    remove_sibling (size_t id)
-    {
-      for (SignalLink *link = this->next ? this->next : this; link != this; link = link->next)
-        if (id == size_t (link))
-          {
-            link->unlink();     // deactivate and unlink sibling
-            return true;
-          }
-      return false;
-    }
+    size_t      id;
   };
-  SignalLink   *callback_ring_; // linked ring of callback nodes
+  /// SlotHandle maps the index part of a connection ID to the slot position, the generation detects stale IDs.
+  struct SlotHandle {
+    uint32_t    position;
+    uint32_t    generation;
+  };
+  /// EmissionScope tracks nested emissions and flushes deferred slot changes once the outermost one returns.
+  struct EmissionScope {
+    ProtoSignal &signal;
+    explicit    EmissionScope (ProtoSignal &s) : signal (s) { ++signal.emission_depth_; }
+    /*dtor*/   ~EmissionScope ()                           { if (--signal.emission_depth_ == 0) signal.flush_slots(); }
+  };
+  std::vector<SignalSlot> slots_;         // callbacks in connection order, never relocated during an emission
+  std::deque<SignalSlot>  pending_slots_; // callbacks connected during an emission, never relocated either
+  std::vector<SlotHandle> handles_;       // indexed by the low 32 bits of connection IDs
+  std::vector<uint32_t>   free_handles_;
+  size_t        tombstone_count_;         // disconnected slots left in slots_
+  size_t        connection_count_;
+  unsigned      emission_depth_;
   /*copy-ctor*/ ProtoSignal (const ProtoSignal&) = delete;
   ProtoSignal&  operator=   (const ProtoSignal&) = delete;
+  static size_t   make_id           (uint32_t index, uint32_t generation) { return size_t (generation) << 32 | index; }
+  static uint32_t id_index          (size_t id)                           { return uint32_t (id); }
+  static uint32_t id_generation     (size_t id)                           { return uint32_t (id >> 32); }
+  /// Removes tombstones from slots_, keeping connection order, and updates the handles of the moved slots.
   void
-  ensure_ring ()
+  compact_slots ()
   {
-    if (!callback_ring_)
-      {
-        callback_ring_ = new SignalLink (CbFunction()); // ref_count = 1
-        callback_ring_->incref(); // ref_count = 2, head of ring, can be deactivated but not removed
-        callback_ring_->next = callback_ring_; // ring head initialization
-        callback_ring_->prev = callback_ring_; // ring tail initialization
-      }
+    size_t size = 0;
+    for (size_t position = 0; position < slots_.size(); ++position)
+      if (slots_[position].id != 0)
+        {
+          if (position != size)
+            slots_[size] = std::move (slots_[position]);
+          handles_[id_index (slots_[size].id)].position = uint32_t (size);
+          ++size;
+        }
+    slots_.resize (size);
+    tombstone_count_ = 0;
+  }
+  void
+  flush_slots ()
+  {
+    if (tombstone_count_)
+      compact_slots();
+    for (SignalSlot &slot : pending_slots_)
+      if (slot.id != 0)
+        {
+          handles_[id_index (slot.id)].position = uint32_t (slots_.size());
+          slots_.push_back (std::move (slot));
+        }
+    pending_slots_.clear();
   }
 public:
   /// ProtoSignal constructor, connects default callback if non-nullptr.
   ProtoSignal (const CbFunction &method) :
-    callback_ring_ (nullptr)
+    tombstone_count_ (0), connection_count_ (0), emission_depth_ (0)
   {
     if (method != nullptr)
-      {
-        ensure_ring();
-        callback_ring_->function = method;
-      }
+      connect (method);
   }
   /// ProtoSignal destructor releases all resources associated with this signal.
   ~ProtoSignal ()
   {
-    if (callback_ring_)
+    assert (emission_depth_ == 0);
+  }
+  /// Operator to add a new function or lambda as signal handler, returns a handler connection ID.
+  /// Handlers added during an emission are also invoked by the running emissions, after the other handlers.
+  /// A connection ID packs a slot index and a generation, its two top bits are never set.
+  size_t
+  connect (CbFunction cb)
+  {
+    uint32_t index;
+    if (!free_handles_.empty())
+      {
+        index = free_handles_.back();
+        free_handles_.pop_back();
+      }
+    else
+      {
+        index = uint32_t (handles_.size());
+        handles_.push_back (SlotHandle { free_position, 1 });
+      }
+    SlotHandle &handle = handles_[index];
+    const size_t id = make_id (index, handle.generation);
+    if (emission_depth_)
       {
-        while (callback_ring_->next != callback_ring_)
-          callback_ring_->next->unlink();
-        assert (callback_ring_->ref_count >= 2);
-        callback_ring_->decref();
-        callback_ring_->decref();
+        handle.position = uint32_t (pending_slots_.size()) | pending_position_flag;
+        pending_slots_.push_back (SignalSlot { std::move (cb), id });
       }
+    else
+      {
+        handle.position = uint32_t (slots_.size());
+        slots_.push_back (SignalSlot { std::move (cb), id });
+      }
+    ++connection_count_;
+    return id;
   }
-  /// Operator to add a new function or lambda as signal handler, returns a handler connection ID.
-  size_t connect (const CbFunction &cb)      { ensure_ring(); return callback_ring_->add_before (cb); }
   /// Operator to remove a signal handler through it connection ID, returns if a handler was removed.
-  bool   disconnect (size_t connection)         { return callback_ring_ ? callback_ring_->remove_sibling (connection) : false; }
+  /// Constant time: the slot is marked as disconnected and compacted later, stale IDs are detected by their generation.
+  /// During an emission the callback is kept alive until the emission ends, so a handler may safely remove itself.
+  bool
+  disconnect (size_t connection)
+  {
+    const uint32_t index = id_index (connection);
+    if (index >= handles_.size())
+      return false;
+    SlotHandle &handle = handles_[index];
+    if (handle.generation != id_generation (connection) || handle.position == free_position)
+      return false;
+    if (handle.position & pending_position_flag)
+      pending_slots_[handle.position & ~pending_position_flag].id = 0;
+    else
+      {
+        SignalSlot &slot = slots_[handle.position];
+        slot.id = 0;
+        ++tombstone_count_;
+        if (!emission_depth_)
+          {
+            slot.function = nullptr;
+            if (tombstone_count_ * 2 > slots_.size())
+              compact_slots();
+          }
+      }
+    handle.position = free_position;
+    handle.generation = uint32_t ((handle.generation + 1) & generation_mask);
+    if (handle.generation == 0)
+      handle.generation = 1;
+    free_handles_.push_back (index);
+    --connection_count_;
+    return true;
+  }
   /// Emit a signal, i.e. invoke all its callbacks and collect return types with the Collector.
   CollectorResult
   emit (Args... args)
   {
     Collector collector;
-    if (!callback_ring_)
+    if (slots_.empty())
       return collector.result();
-    SignalLink *link = callback_ring_;
-    link->incref();
-    do
-      {
-        if (link->function != nullptr)
-          {
-            const bool continue_emission = this->invoke (collector, link->function, args...);
-            if (!continue_emission)
-              break;
-          }
-        SignalLink *old = link;
-        link = old->next;
-        link->incref();
-        old->decref();
-      }
-    while (link != callback_ring_);
-    link->decref();
+    EmissionScope scope (*this);
+    for (SignalSlot *slot = slots_.data(), *end = slot + slots_.size(); slot != end; ++slot)
+      if (slot->id != 0 && !this->invoke (collector, slot->function, args...))
+        return collector.result();
+    // pending_slots_ may grow while its handlers run.
+    for (size_t position = 0; position < pending_slots_.size(); ++position)
+      if (pending_slots_[position].id != 0 && !this->invoke (collector, pending_slots_[position].function, args...))
+        break;
     return collector.result();
   }
+  /// Emit a signal through @a partition, which is called with the number of slots and a function invoking the
+  /// slots in [first, last), and must call it over a partition of [0, count) before returning, possibly from
+  /// several threads. Only for signals with void return type. Unless @a partition calls it sequentially on the
+  /// emitting thread, handlers must not connect or disconnect handlers of this signal during such an emission.
+  /// Handlers connected during the emission are invoked afterwards, on the emitting thread.
+  template<class Partitioner> void
+  emit_partitioned (Partitioner &&partition, Args... args)
+  {
+    static_assert (std::is_void<R>::value, "partitioned emissions do not collect results");
+    if (slots_.empty())
+      return;
+    EmissionScope scope (*this);
+    const SignalSlot *slots = slots_.data();
+    partition (slots_.size(), [slots, &args...] (size_t first, size_t last) {
+      for (const SignalSlot *slot = slots + first, *end = slots + last; slot != end; ++slot)
+        if (slot->id != 0)
+          slot->function (args...);
+    });
+    for (size_t position = 0; position < pending_slots_.size(); ++position)
+      if (pending_slots_[position].id != 0)
+        pending_slots_[position].function (args...);
+  }
   // Number of connected slots.
   int
   size ()
   {
-    int size = 0;
-    SignalLink *link = callback_ring_;
-    link->incref();
-    do
-      {
-        if (link->function != 0)
-          {
-            size++;
-          }
-        SignalLink *old = link;
-        link = old->next;
-        link->incref();
-        old->decref();
-      }
-    while (link != callback_ring_);
-    return size;
+    return int (connection_count_);
   }
 };
 
@@ -208,7 +266,7 @@ public:
 /**
  * Signal is a template type providing an interface for arbitrary callback lists.
  * A signal type needs to be declared with the function signature of its callbacks,
- * and optionally a return result collector class type.
+ * and optionally a return result collector class type and a callback wrapper type (std::function by default).
  * Signal callbacks can be added with operator+= to a signal and removed with operator-=, using
  * a callback connection ID return by operator+= as argument.
  * The callbacks of a signal are invoked with the emit() method and arguments according to the signature.
@@ -216,15 +274,18 @@ public:
  * the last callback is returned from emit(). Collectors can be implemented to accumulate callback
  * results or to halt a running emissions in correspondance to callback results.
  * The signal implementation is safe against recursion, so callbacks may be removed and
- * added during a signal emission and recursive emit() calls are also safe.
- * The overhead of an unused signal is intentionally kept very low, around the size of a single pointer.
+ * added during a signal emission and recursive emit() calls are also safe. Callbacks added
+ * during an emission are invoked by that emission too, after the callbacks connected before it.
+ * Callbacks are stored in a contiguous array, so an emission is a linear scan without any per-callback
+ * allocation or reference counting; an unused signal does not allocate.
  * Note that the Signal template types is non-copyable.
  */
-template <typename SignalSignature, class Collector = Lib::CollectorDefault<typename std::function<SignalSignature>::result_type> >
+template <typename SignalSignature, class Collector = Lib::CollectorDefault<typename std::function<SignalSignature>::result_type>,
+          class Function = std::function<SignalSignature> >
 struct Signal /*final*/ :
-    Lib::ProtoSignal<SignalSignature, Collector>
+    Lib::ProtoSignal<SignalSignature, Collector, Function>
 {
-  using ProtoSignal = Lib::ProtoSignal<SignalSignature, Collector>;
+  using ProtoSignal = Lib::ProtoSignal<SignalSignature, Collector, Function>;
   using CbFunction = typename ProtoSignal::CbFunction;
   /// Signal constructor, supports a default callback as argument.
   Signal (const CbFunction &method = CbFunction()) : ProtoSignal (method) {}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+namespace evnt::priv
+{
+// Owning pointer to an immutable value which readers access without locking (RCU-like).
+// Readers enter a short read section, counted in one of two epoch counters. A writer publishes a
+// new value, flips the epoch and waits for the readers of the previous epochs before deleting
+// the old value. Writers must be serialized by the caller.
+template <class value_type>
+class snapshot_ptr
+{
+    struct alignas(64) reader_counter
+    {
+        std::atomic_size_t count = 0;
+    };
+
+public:
+    class read_section
+    {
+    public:
+        explicit read_section(const snapshot_ptr& snapshot)
+            : counter_(snapshot.readers_[snapshot.epoch_.load() & 1].count)
+        {
+            counter_.fetch_add(1);
+            value_ = snapshot.value_.load();
+        }
+
+        ~read_section()
+        {
+            counter_.fetch_sub(1, std::memory_order_release);
+        }
+
+        read_section(const read_section&) = delete;
+        read_section& operator=(const read_section&) = delete;
+
+        inline const value_type* get() const { return value_; }
+
+    private:
+        std::atomic_size_t& counter_;
+        const value_type* value_;
+    };
+
+    snapshot_ptr() = default;
+    snapshot_ptr(const snapshot_ptr&) = delete;
+    snapshot_ptr& operator=(const snapshot_ptr&) = delete;
+
+    ~snapshot_ptr()
+    {
+        delete value_.load(std::memory_order_acquire);
+    }
+
+    // Cheap check which does not enter a read section.
+    inline bool empty() const { return value_.load(std::memory_order_acquire) == nullptr; }
+
+    // Current value, only for writers.
+    inline const value_type* get() const { return value_.load(std::memory_order_acquire); }
+
+    // Publishes value, then waits until no reader can still access the previous one and deletes it.
+    void reset(std::unique_ptr<const value_type> value)
+    {
+        std::unique_ptr<const value_type> old_value(value_.exchange(value.release()));
+        if (!old_value)
+            return;
+        // Two flips: a reader may have read the epoch just before the previous flip and still be
+        // counted in the other counter while using the old value.
+        for (int flip = 0; flip < 2; ++flip)
+        {
+            reader_counter& old_readers = readers_[epoch_.fetch_add(1) & 1];
+            while (old_readers.count.load(std::memory_order_acquire) != 0)
+                std::this_thread::yield();
+        }
+    }
+
+private:
+    std::atomic<const value_type*> value_ = nullptr;
+    std::atomic_size_t epoch_ = 0;
+    mutable std::array<reader_counter, 2> readers_;
+};
+}
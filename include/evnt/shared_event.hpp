@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+
+namespace evnt
+{
+// Handle on an immutable event stored once in a ref-counted block.
+// Emitting a shared_event to several event boxes only copies the handle, every box
+// receives a const view of the same event object.
+template <class event_type>
+class shared_event
+{
+public:
+    explicit shared_event(std::shared_ptr<const event_type> event)
+        : event_(std::move(event))
+    {}
+
+    inline const event_type& get() const { return *event_; }
+    inline const event_type& operator*() const { return *event_; }
+    inline const event_type* operator->() const { return event_.get(); }
+
+private:
+    std::shared_ptr<const event_type> event_;
+};
+
+template <class event_type, class... argument_types>
+inline shared_event<event_type> make_shared_event(argument_types&&... arguments)
+{
+    return shared_event<event_type>(std::make_shared<const event_type>(std::forward<argument_types>(arguments)...));
+}
+}
@@ -1,18 +1,25 @@
 #pragma once
 
+#include "delegate.hpp"
 #include "priv/simple_signal.hpp"
 
 namespace evnt
 {
 template <typename SignalSignature,
           class Collector = Simple::Lib::CollectorDefault<typename std::function<SignalSignature>::result_type> >
-using signal = Simple::Signal<SignalSignature, Collector>;
+using signal = Simple::Signal<SignalSignature, Collector, delegate<SignalSignature>>;
 
-template <class Instance, class Class, class R, class... Args> std::function<R (Args...)>
-inline slot (Instance &object, R (Class::*method) (Args...)) { return Simple::slot(object, method); }
+template <class Instance, class Class, class R, class... Args> delegate<R (Args...)>
+inline slot (Instance &object, R (Class::*method) (Args...))
+{
+    return [&object, method] (Args... args) { return (object .* method) (args...); };
+}
 
-template<class Class, class R, class... Args> std::function<R (Args...)>
-slot (Class *object, R (Class::*method) (Args...)) { return Simple::slot(object, method); }
+template<class Class, class R, class... Args> delegate<R (Args...)>
+slot (Class *object, R (Class::*method) (Args...))
+{
+    return [object, method] (Args... args) { return (object ->* method) (args...); };
+}
 
 template <typename Result>
 using Collector_until_0 = Simple::CollectorUntil0<Result>;
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "event_listener.hpp"
+#include "event_manager.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <thread>
+
+namespace evnt
+{
+// How the consumer of a spsc_channel waits for events:
+//  - busy_poll: wait() spins on the ring, for the lowest latency at the cost of a core,
+//  - blocking: wait() sleeps on an atomic (a futex on Linux), producers only notify while the consumer sleeps.
+enum class wait_policy : std::uint8_t
+{
+    busy_poll,
+    blocking,
+};
+
+// Bridge for the events of one type between a producer thread, which emits them with a source event_manager,
+// and a consumer thread, which emits them with a destination event_manager: a lighter alternative to event_box
+// for this topology. Events are copied into a bounded ring without locks. The producer publishes its index once
+// per emission (one event or a batch) and the consumer once per emit_received_events(), on separate cache lines.
+// The producer waits while the ring is full: it must not be the consumer thread.
+template <class event_type>
+class spsc_channel : public event_listener<event_type>
+{
+    static constexpr std::size_t cache_line_size = 64;
+
+public:
+    spsc_channel(event_manager& source, std::size_t capacity = 1024, wait_policy policy = wait_policy::blocking,
+                 std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : allocator_(resource), capacity_(std::bit_ceil(std::max<std::size_t>(capacity, 2))), policy_(policy)
+    {
+        values_ = static_cast<event_type*>(allocator_.allocate_bytes(capacity_ * sizeof(event_type), alignof(event_type)));
+        source.connect<event_type>(*this);
+    }
+
+    spsc_channel(const spsc_channel&) = delete;
+    spsc_channel& operator=(const spsc_channel&) = delete;
+
+    ~spsc_channel()
+    {
+        this->template disconnect<event_type>();
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        destroy_(head, tail_.load(std::memory_order_acquire) - head);
+        allocator_.deallocate_bytes(values_, capacity_ * sizeof(event_type), alignof(event_type));
+    }
+
+    inline std::size_t capacity() const { return capacity_; }
+    inline wait_policy policy() const { return policy_; }
+
+    // Producer (source event manager):
+
+    void receive(std::span<event_type> events)
+    {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        for (std::size_t offset = 0; offset < events.size();)
+        {
+            if (tail - cached_head_ == capacity_)
+            {
+                cached_head_ = head_.load(std::memory_order_acquire);
+                if (tail - cached_head_ == capacity_)
+                {
+                    // Lets the consumer drain the events of this batch already in the ring.
+                    publish_(tail);
+                    std::this_thread::yield();
+                    continue;
+                }
+            }
+            const std::size_t count = std::min(capacity_ - (tail - cached_head_), events.size() - offset);
+            for (std::size_t index = 0; index < count; ++index)
+                ::new (static_cast<void*>(values_ + ((tail + index) & mask_()))) event_type(events[offset + index]);
+            tail += count;
+            offset += count;
+        }
+        publish_(tail);
+    }
+
+    // Consumer (destination event manager):
+
+    // Emits the events published so far with evt_manager, as one or two batches. Returns the number of events.
+    std::size_t emit_received_events(event_manager& evt_manager)
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t count = tail_.load(std::memory_order_acquire) - head;
+        if (count == 0)
+            return 0;
+
+        const std::size_t first_index = head & mask_();
+        const std::size_t first_count = std::min(count, capacity_ - first_index);
+        evt_manager.emit(std::span<event_type>(values_ + first_index, first_count));
+        if (count > first_count)
+            evt_manager.emit(std::span<event_type>(values_, count - first_count));
+        destroy_(head, count);
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    inline bool empty() const
+    {
+        return tail_.load(std::memory_order_acquire) == head_.load(std::memory_order_relaxed);
+    }
+
+    // Returns once events are available, or wake_up() was called since the previous wait() returned.
+    // May return spuriously.
+    void wait()
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (policy_ == wait_policy::busy_poll)
+        {
+            // Yields now and then, in case the producer shares the core.
+            for (std::size_t spin_count = 1; tail_.load(std::memory_order_acquire) == head
+                                             && wake_up_count_.load(std::memory_order_acquire) == seen_wake_up_count_; ++spin_count)
+                if (spin_count % 4096 == 0)
+                    std::this_thread::yield();
+        }
+        else
+        {
+            consumer_waiting_.store(true, std::memory_order_seq_cst);
+            // Either the producer sees the consumer waiting, or the consumer sees the published events.
+            while (tail_.load(std::memory_order_seq_cst) == head && wake_up_count_.load(std::memory_order_acquire) == seen_wake_up_count_)
+                wake_up_count_.wait(seen_wake_up_count_, std::memory_order_acquire);
+            consumer_waiting_.store(false, std::memory_order_relaxed);
+        }
+        seen_wake_up_count_ = wake_up_count_.load(std::memory_order_acquire);
+    }
+
+    // Any thread: makes wait() return.
+    void wake_up()
+    {
+        wake_up_count_.fetch_add(1, std::memory_order_release);
+        wake_up_count_.notify_one();
+    }
+
+private:
+    inline std::size_t mask_() const { return capacity_ - 1; }
+
+    void publish_(std::size_t tail)
+    {
+        if (policy_ == wait_policy::busy_poll)
+        {
+            tail_.store(tail, std::memory_order_release);
+            return;
+        }
+        tail_.store(tail, std::memory_order_seq_cst);
+        if (consumer_waiting_.load(std::memory_order_seq_cst))
+        {
+            wake_up_count_.fetch_add(1, std::memory_order_release);
+            wake_up_count_.notify_one();
+        }
+    }
+
+    void destroy_(std::size_t position, std::size_t count)
+    {
+        if constexpr (!std::is_trivially_destructible_v<event_type>)
+            for (std::size_t index = 0; index < count; ++index)
+                values_[(position + index) & mask_()].~event_type();
+    }
+
+private:
+    // Read-only after construction.
+    std::pmr::polymorphic_allocator<> allocator_;
+    std::size_t capacity_;
+    event_type* values_ = nullptr;
+    wait_policy policy_;
+    // Producer line: next position to write, and the last head seen.
+    alignas(cache_line_size) std::atomic_size_t tail_ = 0;
+    std::size_t cached_head_ = 0;
+    // Consumer line: next position to read, and the wake-ups already seen by wait().
+    alignas(cache_line_size) std::atomic_size_t head_ = 0;
+    std::uint32_t seen_wake_up_count_ = 0;
+    // Wake-up line.
+    alignas(cache_line_size) std::atomic_bool consumer_waiting_ = false;
+    std::atomic_uint32_t wake_up_count_ = 0;
+};
+}
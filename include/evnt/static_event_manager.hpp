@@ -0,0 +1,97 @@
+#pragma once
+
+#include "signal.hpp"
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace evnt
+{
+// Event manager whose event types are known at compile time.
+// Signals are members of a std::tuple, so emitting an event is a direct member access:
+// no type index lookup, no heap-allocated signal and no static guard check.
+// It only dispatches to receiver functions of the same thread (no event_box, no event_listener).
+template <class... event_types>
+class static_event_manager
+{
+    template <class event_type>
+    static constexpr bool is_managed_v = (std::is_same_v<event_type, event_types> || ...);
+
+    template <class event_type>
+    static constexpr std::size_t occurrences_v = (std::size_t(std::is_same_v<event_type, event_types>) + ... + 0);
+
+    static_assert(((occurrences_v<event_types> == 1) && ...), "Event types must be unique.");
+
+public:
+    template <class event_type>
+    using receiver_function = delegate<void(event_type&)>;
+
+    static_event_manager() {}
+    static_event_manager(const static_event_manager&) = delete;
+    static_event_manager& operator=(const static_event_manager&) = delete;
+
+    // Connect:
+
+    template <class event_type>
+    requires is_managed_v<event_type>
+    inline std::size_t connect(receiver_function<event_type> listener)
+    {
+        return event_signal_<event_type>().connect(std::move(listener));
+    }
+
+    // Disconnect:
+
+    template <class event_type>
+    requires is_managed_v<event_type>
+    inline void disconnect(std::size_t connection)
+    {
+        event_signal_<event_type>().disconnect(connection);
+    }
+
+    // Emit events:
+
+    template <class event_type>
+    requires is_managed_v<event_type>
+    inline void emit(event_type& event)
+    {
+        event_signal_<event_type>().emit(event);
+    }
+
+    template <class event_type>
+    requires is_managed_v<event_type>
+    inline void emit(event_type&& event)
+    {
+        event_type evt = std::move(event);
+        emit<event_type>(evt);
+    }
+
+    template <class event_type>
+    requires is_managed_v<event_type>
+    inline void emit(std::span<event_type> events)
+    {
+        auto& e_signal = event_signal_<event_type>();
+        for (event_type& event : events)
+            e_signal.emit(event);
+    }
+
+    template <class event_type>
+    requires is_managed_v<event_type>
+    inline void emit(std::vector<event_type>& events)
+    {
+        emit(std::span<event_type>(events));
+    }
+
+private:
+    template <class event_type>
+    inline signal<void(event_type&)>& event_signal_()
+    {
+        return std::get<signal<void(event_type&)>>(event_signals_);
+    }
+
+private:
+    std::tuple<signal<void(event_types&)>...> event_signals_;
+};
+}
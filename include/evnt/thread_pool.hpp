@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace evnt
+{
+// Fixed-size pool of threads running parallel loops.
+class thread_pool
+{
+public:
+    explicit thread_pool(std::size_t number_of_threads = std::thread::hardware_concurrency());
+    ~thread_pool();
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    // Calls function(first, last) over a partition of [0, count) on the pool threads and on the
+    // calling thread, and returns once every call returned. Calls may be nested.
+    template <class function_type>
+    void parallel_for(std::size_t count, function_type&& function)
+    {
+        job loop{ count, chunk_size_(count), &function, [](void* callable, std::size_t first, std::size_t last)
+        {
+            (*static_cast<std::remove_reference_t<function_type>*>(callable))(first, last);
+        } };
+        run_(loop);
+    }
+
+    inline std::size_t number_of_threads() const { return workers_.size(); }
+
+private:
+    struct job
+    {
+        std::size_t count;
+        std::size_t chunk_size;
+        void* callable;
+        void(*invoke)(void* callable, std::size_t first, std::size_t last);
+        std::atomic_size_t next_index = 0;
+        std::atomic_size_t remaining_count = count;
+        // Number of workers which may still access the job, protected by the mutex.
+        std::size_t number_of_workers = 0;
+    };
+
+    std::size_t chunk_size_(std::size_t count) const;
+    void run_(job& loop);
+    // Runs chunks of loop until none is left.
+    static void work_on_(job& loop);
+    void run_worker_();
+
+private:
+    std::vector<std::thread> workers_;
+    std::deque<job*> jobs_;
+    bool stop_ = false;
+    std::condition_variable condition_;
+    std::condition_variable done_condition_;
+    std::mutex mutex_;
+};
+}
@@ -1,4 +1,5 @@
 #include <evnt/async_event_queue.hpp>
+#include <algorithm>
 
 namespace evnt
 {
@@ -6,27 +7,119 @@ async_event_queue::async_event_queue_interface::~async_event_queue_interface()
 {
 }
 
+std::vector<event_type_stats> async_event_queue::stats() const
+{
+    std::vector<event_type_stats> stats;
+    if constexpr (stats_enabled)
+        event_queues_.for_each([&stats](async_event_queue_interface& event_queue)
+        {
+            event_queue.collect_stats(stats.emplace_back());
+        });
+    return stats;
+}
+
 void async_event_queue::sync()
 {
-    for (async_event_queue_interface_uptr& event_queue : event_queues_)
-        if (event_queue)
-            event_queue->sync();
+    std::size_t number_of_events = sync_records_();
+    event_queues_.for_each([&number_of_events](async_event_queue_interface& event_queue)
+    {
+        number_of_events += event_queue.sync();
+    });
+    pending_event_count_.fetch_sub(number_of_events, std::memory_order_relaxed);
 }
 
 void async_event_queue::sync_and_emit_events(event_manager& evt_manager)
 {
-    for (async_event_queue_interface_uptr& event_queue : event_queues_)
-        if (event_queue)
-        {
-            event_queue->sync();
-            event_queue->emit(evt_manager);
-        }
+    if (delivery_order_ == delivery_order::as_pushed)
+    {
+        pending_event_count_.fetch_sub(sync_records_(), std::memory_order_relaxed);
+        records_.invoke_all(&evt_manager);
+        return;
+    }
+
+    for (async_event_queue_interface* event_queue : emission_order_())
+    {
+        pending_event_count_.fetch_sub(event_queue->sync(), std::memory_order_relaxed);
+        event_queue->emit(evt_manager, forward_synced_events_);
+    }
+    start_next_pass_();
+}
+
+bool async_event_queue::sync_and_emit_events(event_manager& evt_manager, std::chrono::steady_clock::time_point deadline)
+{
+    if (delivery_order_ == delivery_order::as_pushed)
+    {
+        sync_and_emit_events(evt_manager);
+        return true;
+    }
+
+    // Resumes the pass of the previous call at the type where it stopped.
+    const std::vector<async_event_queue_interface*>& event_queues = emission_order_();
+    for (; next_emission_index_ < event_queues.size(); ++next_emission_index_)
+    {
+        if (std::chrono::steady_clock::now() >= deadline)
+            return false;
+        async_event_queue_interface* event_queue = event_queues[next_emission_index_];
+        pending_event_count_.fetch_sub(event_queue->sync(), std::memory_order_relaxed);
+        event_queue->emit(evt_manager, forward_synced_events_);
+    }
+    start_next_pass_();
+    return true;
 }
 
 void async_event_queue::emit_events(event_manager& evt_manager)
 {
-    for (const async_event_queue_interface_uptr& event_queue : event_queues_)
-        if (event_queue)
-            event_queue->emit(evt_manager);
+    records_.invoke_all(&evt_manager);
+    for (async_event_queue_interface* event_queue : emission_order_())
+        event_queue->emit(evt_manager, false);
+}
+
+const std::vector<async_event_queue::async_event_queue_interface*>& async_event_queue::emission_order_()
+{
+    std::size_t version = emission_order_version_.load(std::memory_order_acquire);
+    if (version != emission_order_cache_version_)
+    {
+        emission_order_cache_.clear();
+        event_queues_.for_each([this](async_event_queue_interface& event_queue)
+        {
+            emission_order_cache_.push_back(&event_queue);
+        });
+        std::stable_sort(emission_order_cache_.begin(), emission_order_cache_.end(),
+                         [](const async_event_queue_interface* lhs, const async_event_queue_interface* rhs)
+        {
+            return lhs->priority() > rhs->priority();
+        });
+        emission_order_cache_version_ = version;
+        next_emission_index_ = 0;
+    }
+    return emission_order_cache_;
+}
+
+void async_event_queue::start_next_pass_()
+{
+    next_emission_index_ = 0;
+    // Rotates the types of each priority level, so that they take turns being emitted first.
+    for (auto first = emission_order_cache_.begin(); first != emission_order_cache_.end();)
+    {
+        const int priority = (*first)->priority();
+        auto last = std::find_if(first + 1, emission_order_cache_.end(), [priority](const async_event_queue_interface* event_queue)
+        {
+            return event_queue->priority() != priority;
+        });
+        std::rotate(first, first + 1, last);
+        first = last;
+    }
+}
+
+std::size_t async_event_queue::sync_records_()
+{
+    if (delivery_order_ != delivery_order::as_pushed)
+        return 0;
+
+    std::lock_guard<std::mutex> lock(records_mutex_);
+    // The blocks of the previous records are reused by the next pushed ones.
+    records_.clear();
+    records_.swap(pending_records_);
+    return records_.size();
 }
 }
@@ -0,0 +1,30 @@
+#include <evnt/evnt.hpp>
+
+namespace evnt
+{
+event_batch::event_batch(event_manager& evt_manager, std::pmr::memory_resource* resource)
+    : event_manager_(evt_manager), resource_(resource), staged_events_(resource), runs_(resource)
+{
+}
+
+event_batch::~event_batch()
+{
+    flush();
+    for (staged_events_interface* events : staged_events_)
+        if (events)
+            events->destroy(resource_);
+}
+
+void event_batch::flush()
+{
+    if (runs_.empty())
+        return;
+
+    for (const run& events_run : runs_)
+        events_run.events->flush(event_manager_, events_run.count);
+    for (const run& events_run : runs_)
+        events_run.events->clear();
+    runs_.clear();
+    staged_event_count_ = 0;
+}
+}
@@ -1,22 +1,76 @@
 #include <evnt/event_box.hpp>
+#include <algorithm>
 
 namespace evnt
 {
+event_box::event_box(std::pmr::memory_resource* resource)
+    : event_box(async_event_queue::delivery_order::by_type, resource)
+{
+}
+
+event_box::event_box(async_event_queue::delivery_order order, std::pmr::memory_resource* resource)
+    : event_queue_(order, resource), event_manager_(resource)
+{
+    event_manager_.owner_box_ = this;
+    event_queue_.forward_synced_events_ = true;
+}
+
 event_box::~event_box()
 {
-    std::lock_guard lock(mutex_);
-    if (parent_event_manager_)
+    // The parent event manager locks its mutex, then the one of the box: disconnect outside mutex_.
+    event_manager* parent_event_manager = nullptr;
     {
-        parent_event_manager_->disconnect(*this);
-        parent_event_manager_ = nullptr;
+        std::lock_guard lock(mutex_);
+        parent_event_manager = parent_event_manager_;
     }
+    if (parent_event_manager)
+        parent_event_manager->disconnect(*this);
+}
+
+void event_box::connect(event_box& child)
+{
+    assert(&child != this);
+    event_manager_.connect(child);
+}
+
+void event_box::disconnect(event_box& child)
+{
+    event_manager_.disconnect(child);
 }
 
 void event_box::emit_received_events()
 {
+    priv::trace_span span("emit_received_events", nullptr);
     event_queue_.sync_and_emit_events(event_manager_);
 }
 
+bool event_box::emit_received_events(std::chrono::steady_clock::time_point deadline)
+{
+    priv::trace_span span("emit_received_events", nullptr);
+    return event_queue_.sync_and_emit_events(event_manager_, deadline);
+}
+
+std::vector<event_type_stats> event_box::stats()
+{
+    std::vector<event_type_stats> stats = event_queue_.stats();
+    for (const event_type_stats& emission_stats : event_manager_.stats())
+    {
+        auto iter = std::find_if(stats.begin(), stats.end(), [&emission_stats](const event_type_stats& type_stats)
+        {
+            return type_stats.type_index == emission_stats.type_index;
+        });
+        event_type_stats& type_stats = iter != stats.end() ? *iter : stats.emplace_back();
+        const std::uint64_t pushed_events = type_stats.pushed_events;
+        const std::size_t max_queue_depth = type_stats.max_queue_depth;
+        const duration_histogram delivery_latency = type_stats.delivery_latency;
+        type_stats = emission_stats;
+        type_stats.pushed_events = pushed_events;
+        type_stats.max_queue_depth = max_queue_depth;
+        type_stats.delivery_latency = delivery_latency;
+    }
+    return stats;
+}
+
 void event_box::set_parent_event_manager(event_manager& evt_manager)
 {
     std::lock_guard lock(mutex_);
@@ -26,11 +80,28 @@ void event_box::set_parent_event_manager(event_manager& evt_manager)
 
 void event_box::set_parent_event_manager(std::nullptr_t)
 {
-    if (mutex_.try_lock())
+    std::lock_guard lock(mutex_);
+    assert(parent_event_manager_);
+    parent_event_manager_ = nullptr;
+}
+
+void event_box::subscribe_(std::size_t event_type_index)
+{
+    event_manager* parent_event_manager = nullptr;
     {
-        std::lock_guard lock(mutex_, std::adopt_lock);
-        assert(parent_event_manager_);
-        parent_event_manager_ = nullptr;
+        std::lock_guard lock(mutex_);
+        if (std::find(event_type_indices_.begin(), event_type_indices_.end(), event_type_index) != event_type_indices_.end())
+            return;
+        event_type_indices_.push_back(event_type_index);
+        parent_event_manager = parent_event_manager_;
     }
+    if (parent_event_manager)
+        parent_event_manager->update_dispatcher_routes_(*this);
+}
+
+std::vector<std::size_t> event_box::subscribed_event_types_()
+{
+    std::lock_guard lock(mutex_);
+    return event_type_indices_;
 }
 }
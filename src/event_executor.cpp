@@ -0,0 +1,149 @@
+#include <evnt/event_executor.hpp>
+#include <algorithm>
+#include <iterator>
+
+namespace evnt
+{
+event_executor::event_executor(std::size_t number_of_threads, std::chrono::microseconds idle_wait_duration)
+    : idle_wait_duration_(idle_wait_duration)
+{
+    number_of_threads = std::max<std::size_t>(number_of_threads, 1);
+    workers_.reserve(number_of_threads);
+    for (std::size_t worker_index = 0; worker_index < number_of_threads; ++worker_index)
+        workers_.emplace_back([this, worker_index] { run_(worker_index); });
+}
+
+event_executor::~event_executor()
+{
+    stop_ = true;
+    notify();
+    for (std::thread& worker : workers_)
+        worker.join();
+}
+
+void event_executor::add(event_box& evt_box)
+{
+    std::lock_guard lock(mutex_);
+    box_entry_sptr entry = std::make_shared<box_entry>();
+    entry->evt_box = &evt_box;
+    entry->worker_index = next_worker_index_++ % workers_.size();
+    auto entries = std::make_unique<box_entry_list>();
+    if (const box_entry_list* current_entries = entries_.get())
+        *entries = *current_entries;
+    entries->push_back(std::move(entry));
+    entries_.reset(std::move(entries));
+    ++entries_version_;
+}
+
+void event_executor::remove(event_box& evt_box)
+{
+    box_entry_sptr entry;
+    {
+        std::lock_guard lock(mutex_);
+        const box_entry_list* current_entries = entries_.get();
+        if (!current_entries)
+            return;
+        auto iter = std::find_if(current_entries->begin(), current_entries->end(), [&evt_box](const box_entry_sptr& entry)
+        {
+            return entry->evt_box == &evt_box;
+        });
+        if (iter == current_entries->end())
+            return;
+        entry = *iter;
+        auto entries = std::make_unique<box_entry_list>();
+        entries->reserve(current_entries->size() - 1);
+        std::remove_copy(current_entries->begin(), current_entries->end(), std::back_inserter(*entries), entry);
+        // Waits for the workers looking for a box to steal in the previous list.
+        entries_.reset(std::move(entries));
+        ++entries_version_;
+    }
+    // A worker may still hold the entry in its copy of the list: it checks removed after acquiring busy.
+    entry->removed = true;
+    while (entry->busy)
+        std::this_thread::yield();
+}
+
+void event_executor::notify()
+{
+    {
+        std::lock_guard lock(mutex_);
+        ++notification_count_;
+    }
+    condition_.notify_all();
+}
+
+bool event_executor::try_process_(box_entry& entry)
+{
+    if (entry.busy.exchange(true))
+        return false;
+    bool processed = false;
+    if (!entry.removed && entry.evt_box->pending_event_count() > 0)
+    {
+        entry.evt_box->emit_received_events();
+        processed = true;
+    }
+    entry.busy = false;
+    return processed;
+}
+
+event_executor::box_entry_sptr event_executor::find_deepest_entry_()
+{
+    // Steal the box with the deepest backlog which is not being processed. The copy of the entries of the worker
+    // may contain removed boxes: the current entries are read instead.
+    decltype(entries_)::read_section entries(entries_);
+    if (!entries.get())
+        return nullptr;
+    box_entry_sptr deepest_entry;
+    std::size_t deepest_backlog = 0;
+    for (const box_entry_sptr& entry : *entries.get())
+    {
+        if (entry->removed || entry->busy)
+            continue;
+        std::size_t backlog = entry->evt_box->pending_event_count();
+        if (backlog > deepest_backlog)
+        {
+            deepest_entry = entry;
+            deepest_backlog = backlog;
+        }
+    }
+    return deepest_entry;
+}
+
+void event_executor::run_(std::size_t worker_index)
+{
+    box_entry_list entries;
+    std::size_t entries_version = std::size_t(-1);
+    std::size_t notification_count = 0;
+
+    while (!stop_)
+    {
+        if (entries_version != entries_version_)
+        {
+            std::lock_guard lock(mutex_);
+            entries.clear();
+            if (const box_entry_list* current_entries = entries_.get())
+                entries = *current_entries;
+            entries_version = entries_version_;
+        }
+
+        bool worked = false;
+        for (box_entry_sptr& entry : entries)
+            if (entry->worker_index == worker_index)
+                worked = try_process_(*entry) || worked;
+
+        if (!worked)
+            if (box_entry_sptr deepest_entry = find_deepest_entry_())
+                worked = try_process_(*deepest_entry);
+
+        if (!worked)
+        {
+            std::unique_lock lock(mutex_);
+            condition_.wait_for(lock, idle_wait_duration_, [this, notification_count]
+            {
+                return notification_count != notification_count_ || stop_;
+            });
+            notification_count = notification_count_;
+        }
+    }
+}
+}
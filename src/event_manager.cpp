@@ -1,39 +1,104 @@
 #include <evnt/event_manager.hpp>
 #include <evnt/event_box.hpp>
+#include <algorithm>
+#include <iterator>
 
 namespace evnt
 {
 event_manager::~event_manager()
 {
     std::lock_guard lock(mutex_);
-    for (event_box* dispatcher : event_boxs_)
-    {
-        assert(dispatcher);
-        dispatcher->set_parent_event_manager(nullptr);
-    }
+    if (const dispatcher_list* dispatchers = dispatchers_.get())
+        for (event_box* dispatcher : dispatchers->event_boxs)
+        {
+            assert(dispatcher);
+            dispatcher->set_parent_event_manager(nullptr);
+        }
 }
 
 void event_manager::connect(event_box& dispatcher)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    dispatcher.set_parent_event_manager(*this);
-    event_boxs_.push_back(&dispatcher);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dispatcher.set_parent_event_manager(*this);
+        std::vector<event_box*> event_boxs;
+        if (const dispatcher_list* dispatchers = dispatchers_.get())
+            event_boxs = dispatchers->event_boxs;
+        event_boxs.push_back(&dispatcher);
+        publish_dispatchers_(std::move(event_boxs));
+    }
+    subscribe_owner_box_(dispatcher);
 }
 
 void event_manager::disconnect(event_box& dispatcher)
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto iter = std::find(event_boxs_.begin(), event_boxs_.end(), &dispatcher);
-    if (iter != event_boxs_.end())
+    const dispatcher_list* dispatchers = dispatchers_.get();
+    if (!dispatchers)
+        return;
+    auto iter = std::find(dispatchers->event_boxs.begin(), dispatchers->event_boxs.end(), &dispatcher);
+    if (iter != dispatchers->event_boxs.end())
     {
         dispatcher.set_parent_event_manager(nullptr);
-        std::iter_swap(iter, std::prev(event_boxs_.end()));
-        event_boxs_.pop_back();
+        std::vector<event_box*> event_boxs;
+        event_boxs.reserve(dispatchers->event_boxs.size() - 1);
+        std::remove_copy(dispatchers->event_boxs.begin(), dispatchers->event_boxs.end(),
+                         std::back_inserter(event_boxs), &dispatcher);
+        publish_dispatchers_(std::move(event_boxs));
     }
 }
 
+void event_manager::update_dispatcher_routes_(event_box& dispatcher)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const dispatcher_list* dispatchers = dispatchers_.get();
+        if (!dispatchers || std::find(dispatchers->event_boxs.begin(), dispatchers->event_boxs.end(), &dispatcher)
+                                == dispatchers->event_boxs.end())
+            return;
+        publish_dispatchers_(dispatchers->event_boxs);
+    }
+    subscribe_owner_box_(dispatcher);
+}
+
+void event_manager::subscribe_owner_box_(event_box& dispatcher)
+{
+    // Outside mutex_: the subscription goes up the tree, locking one level at a time.
+    if (owner_box_)
+        for (std::size_t event_type_index : dispatcher.subscribed_event_types_())
+            owner_box_->subscribe_(event_type_index);
+}
+
+void event_manager::publish_dispatchers_(std::vector<event_box*> event_boxs)
+{
+    std::unique_ptr<dispatcher_list> dispatchers;
+    if (!event_boxs.empty())
+    {
+        dispatchers = std::make_unique<dispatcher_list>();
+        for (event_box* dispatcher : event_boxs)
+            for (std::size_t event_type_index : dispatcher->subscribed_event_types_())
+            {
+                if (event_type_index >= dispatchers->routes.size())
+                    dispatchers->routes.resize(event_type_index + 1);
+                dispatchers->routes[event_type_index].push_back(dispatcher);
+            }
+        dispatchers->event_boxs = std::move(event_boxs);
+    }
+    dispatchers_.reset(std::move(dispatchers));
+}
+
 void event_manager::reserve(std::size_t number_of_event_types)
 {
     event_signals_.reserve(number_of_event_types);
 }
+
+std::vector<event_type_stats> event_manager::stats()
+{
+    std::vector<event_type_stats> stats;
+    if constexpr (stats_enabled)
+        for (event_signal_interface_uptr& event_signal : event_signals_)
+            if (event_signal)
+                stats.push_back(event_signal->stats());
+    return stats;
+}
 }
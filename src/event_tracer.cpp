@@ -0,0 +1,280 @@
+#include <evnt/event_tracer.hpp>
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+
+namespace evnt
+{
+namespace
+{
+// Records of a thread. Only the owner thread appends records, and publishes them through the size of their chunk.
+// Readers and resets are serialized by the registry mutex.
+class thread_trace_buffer
+{
+    static constexpr std::size_t chunk_capacity = 4096;
+    static constexpr std::size_t max_number_of_chunks = 64;
+
+    struct chunk
+    {
+        std::array<priv::trace_record, chunk_capacity> records;
+        std::atomic_size_t size = 0;
+        std::atomic<chunk*> next = nullptr;
+    };
+
+public:
+    explicit thread_trace_buffer(std::size_t thread_id)
+        : thread_id_(thread_id)
+    {}
+
+    ~thread_trace_buffer()
+    {
+        free_chunks_(first_chunk_.next.exchange(nullptr));
+    }
+
+    inline std::size_t thread_id() const { return thread_id_; }
+    inline std::uint64_t session() const { return session_.load(std::memory_order_acquire); }
+
+    // Owner thread:
+    bool append(const priv::trace_record& record)
+    {
+        std::size_t size = last_chunk_->size.load(std::memory_order_relaxed);
+        if (size == chunk_capacity)
+        {
+            if (number_of_chunks_ == max_number_of_chunks)
+                return false;
+            chunk* n_chunk = new chunk;
+            last_chunk_->next.store(n_chunk, std::memory_order_release);
+            last_chunk_ = n_chunk;
+            ++number_of_chunks_;
+            size = 0;
+        }
+        last_chunk_->records[size] = record;
+        last_chunk_->size.store(size + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Owner thread, with the registry mutex locked.
+    void reset(std::uint64_t session)
+    {
+        free_chunks_(first_chunk_.next.exchange(nullptr));
+        first_chunk_.size.store(0, std::memory_order_relaxed);
+        last_chunk_ = &first_chunk_;
+        number_of_chunks_ = 1;
+        session_.store(session, std::memory_order_release);
+    }
+
+    // Any thread, with the registry mutex locked.
+    template <class function_type>
+    void for_each_record(function_type&& function) const
+    {
+        for (const chunk* current_chunk = &first_chunk_; current_chunk; current_chunk = current_chunk->next.load(std::memory_order_acquire))
+            for (std::size_t index = 0, size = current_chunk->size.load(std::memory_order_acquire); index < size; ++index)
+                function(current_chunk->records[index]);
+    }
+
+private:
+    static void free_chunks_(chunk* first)
+    {
+        while (first)
+        {
+            chunk* next = first->next.load(std::memory_order_relaxed);
+            delete first;
+            first = next;
+        }
+    }
+
+private:
+    std::size_t thread_id_;
+    std::atomic_uint64_t session_ = 0;
+    chunk first_chunk_;
+    chunk* last_chunk_ = &first_chunk_;
+    std::size_t number_of_chunks_ = 1;
+};
+
+struct trace_registry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<thread_trace_buffer>> buffers;
+    std::vector<thread_trace_buffer*> free_buffers;
+    std::atomic_uint64_t session = 0;
+    std::atomic_uint64_t next_flow_id = 1;
+    std::atomic_uint64_t dropped_records = 0;
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+};
+
+trace_registry& registry()
+{
+    static trace_registry instance;
+    return instance;
+}
+
+// Gives the buffer of a thread back to the registry when the thread exits, so that it is reused by a thread of
+// a next recording.
+class thread_trace_buffer_holder
+{
+public:
+    ~thread_trace_buffer_holder()
+    {
+        if (!buffer)
+            return;
+        trace_registry& traces = registry();
+        std::lock_guard lock(traces.mutex);
+        traces.free_buffers.push_back(buffer);
+    }
+
+    thread_trace_buffer* buffer = nullptr;
+};
+
+thread_trace_buffer& current_thread_buffer(std::uint64_t session)
+{
+    thread_local thread_trace_buffer_holder holder;
+    if (!holder.buffer || holder.buffer->session() != session)
+    {
+        trace_registry& traces = registry();
+        std::lock_guard lock(traces.mutex);
+        if (!holder.buffer)
+        {
+            // The buffers of the threads which exited during this recording are kept for it.
+            auto iter = std::find_if(traces.free_buffers.begin(), traces.free_buffers.end(), [session](thread_trace_buffer* buffer)
+            {
+                return buffer->session() != session;
+            });
+            if (iter == traces.free_buffers.end())
+                holder.buffer = traces.buffers.emplace_back(std::make_unique<thread_trace_buffer>(traces.buffers.size() + 1)).get();
+            else
+            {
+                holder.buffer = *iter;
+                traces.free_buffers.erase(iter);
+            }
+        }
+        if (holder.buffer->session() != session)
+            holder.buffer->reset(session);
+    }
+    return *holder.buffer;
+}
+
+std::string demangle(const char* type_name)
+{
+#if __has_include(<cxxabi.h>)
+    int status = 0;
+    std::unique_ptr<char, void(*)(void*)> name(abi::__cxa_demangle(type_name, nullptr, nullptr, &status), std::free);
+    if (status == 0 && name)
+        return name.get();
+#endif
+    return type_name;
+}
+
+void write_json_string(std::FILE* file, const std::string& text)
+{
+    std::fputc('"', file);
+    for (char character : text)
+    {
+        if (character == '"' || character == '\\')
+            std::fprintf(file, "\\%c", character);
+        else if (static_cast<unsigned char>(character) < 0x20)
+            std::fprintf(file, "\\u%04x", static_cast<unsigned>(character));
+        else
+            std::fputc(character, file);
+    }
+    std::fputc('"', file);
+}
+}
+
+void event_tracer::start()
+{
+    if constexpr (!tracing_enabled)
+        return;
+    trace_registry& traces = registry();
+    std::lock_guard lock(traces.mutex);
+    traces.session.fetch_add(1, std::memory_order_relaxed);
+    traces.dropped_records.store(0, std::memory_order_relaxed);
+    active_.store(true, std::memory_order_relaxed);
+}
+
+void event_tracer::stop()
+{
+    active_.store(false, std::memory_order_relaxed);
+}
+
+std::uint64_t event_tracer::dropped_records()
+{
+    return registry().dropped_records.load(std::memory_order_relaxed);
+}
+
+bool event_tracer::write_chrome_trace(const std::filesystem::path& path)
+{
+    std::unique_ptr<std::FILE, int(*)(std::FILE*)> file(std::fopen(path.string().c_str(), "w"), std::fclose);
+    if (!file)
+        return false;
+
+    trace_registry& traces = registry();
+    std::lock_guard lock(traces.mutex);
+    const std::uint64_t session = traces.session.load(std::memory_order_relaxed);
+    std::unordered_map<const char*, std::string> type_names;
+    const char* separator = "\n";
+    std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file.get());
+    for (const std::unique_ptr<thread_trace_buffer>& buffer : traces.buffers)
+    {
+        if (session == 0 || buffer->session() != session)
+            continue;
+        std::fprintf(file.get(), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":\"thread %zu\"}}",
+                     separator, buffer->thread_id(), buffer->thread_id());
+        separator = ",\n";
+        buffer->for_each_record([&](const priv::trace_record& record)
+        {
+            std::fprintf(file.get(), "%s{\"name\":\"%s\",\"cat\":\"evnt\",\"ph\":\"%c\",\"pid\":1,\"tid\":%zu,\"ts\":%" PRIu64 ".%03" PRIu64,
+                         separator, record.name, static_cast<char>(record.phase), buffer->thread_id(),
+                         record.timestamp_ns / 1000, record.timestamp_ns % 1000);
+            if (record.phase == priv::trace_phase::span)
+                std::fprintf(file.get(), ",\"dur\":%" PRIu64 ".%03" PRIu64, record.duration_ns / 1000, record.duration_ns % 1000);
+            else
+            {
+                std::fprintf(file.get(), ",\"id\":%" PRIu64, record.flow_id);
+                if (record.phase == priv::trace_phase::flow_finish)
+                    std::fputs(",\"bp\":\"e\"", file.get());
+            }
+            if (record.type_name)
+            {
+                auto iter = type_names.find(record.type_name);
+                if (iter == type_names.end())
+                    iter = type_names.emplace(record.type_name, demangle(record.type_name)).first;
+                std::fputs(",\"args\":{\"type\":", file.get());
+                write_json_string(file.get(), iter->second);
+                std::fputc('}', file.get());
+            }
+            std::fputc('}', file.get());
+        });
+    }
+    std::fputs("\n]}\n", file.get());
+    return std::ferror(file.get()) == 0;
+}
+
+namespace priv
+{
+std::uint64_t trace_clock_now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - registry().epoch).count();
+}
+
+std::uint64_t new_trace_flow_id()
+{
+    return registry().next_flow_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+void append_trace_record(const trace_record& record)
+{
+    trace_registry& traces = registry();
+    const std::uint64_t session = traces.session.load(std::memory_order_relaxed);
+    if (session == 0 || !current_thread_buffer(session).append(record))
+        traces.dropped_records.fetch_add(1, std::memory_order_relaxed);
+}
+}
+}
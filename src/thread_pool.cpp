@@ -0,0 +1,89 @@
+#include <evnt/thread_pool.hpp>
+#include <algorithm>
+
+namespace evnt
+{
+thread_pool::thread_pool(std::size_t number_of_threads)
+{
+    number_of_threads = std::max<std::size_t>(number_of_threads, 1);
+    workers_.reserve(number_of_threads);
+    for (std::size_t i = 0; i < number_of_threads; ++i)
+        workers_.emplace_back([this] { run_worker_(); });
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    condition_.notify_all();
+    for (std::thread& worker : workers_)
+        worker.join();
+}
+
+std::size_t thread_pool::chunk_size_(std::size_t count) const
+{
+    // A few chunks per thread, so that threads which finish early help the others.
+    return std::max<std::size_t>(count / ((workers_.size() + 1) * 4), 1);
+}
+
+void thread_pool::work_on_(job& loop)
+{
+    for (;;)
+    {
+        std::size_t first = loop.next_index.fetch_add(loop.chunk_size);
+        if (first >= loop.count)
+            return;
+        std::size_t last = std::min(first + loop.chunk_size, loop.count);
+        loop.invoke(loop.callable, first, last);
+        loop.remaining_count.fetch_sub(last - first);
+    }
+}
+
+void thread_pool::run_(job& loop)
+{
+    if (loop.count == 0)
+        return;
+    {
+        std::lock_guard lock(mutex_);
+        jobs_.push_back(&loop);
+    }
+    condition_.notify_all();
+
+    work_on_(loop);
+
+    std::unique_lock lock(mutex_);
+    // The loop may still be queued if no worker looked at it.
+    auto iter = std::find(jobs_.begin(), jobs_.end(), &loop);
+    if (iter != jobs_.end())
+        jobs_.erase(iter);
+    done_condition_.wait(lock, [&loop] { return loop.remaining_count == 0 && loop.number_of_workers == 0; });
+}
+
+void thread_pool::run_worker_()
+{
+    std::unique_lock lock(mutex_);
+    for (;;)
+    {
+        condition_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+        if (stop_)
+            return;
+
+        job* loop = jobs_.front();
+        if (loop->next_index >= loop->count)
+        {
+            // Every chunk is taken: no thread needs to look at this loop anymore.
+            jobs_.pop_front();
+            continue;
+        }
+
+        ++loop->number_of_workers;
+        lock.unlock();
+        work_on_(*loop);
+        lock.lock();
+        if (--loop->number_of_workers == 0)
+            done_condition_.notify_all();
+    }
+}
+}
@@ -0,0 +1,511 @@
+#include <evnt/evnt.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class int_event
+{
+public:
+    int value;
+};
+
+class producer_event
+{
+public:
+    int producer;
+    int value;
+};
+
+TEST(async_event_queue_tests, test_push_sync_emit)
+{
+    evnt::async_event_queue event_queue;
+    evnt::event_manager event_manager;
+    std::vector<int> values;
+    event_manager.connect<int_event>([&values](int_event& event)
+    {
+        values.push_back(event.value);
+    });
+
+    event_queue.push(int_event{ 1 });
+    event_queue.push(int_event{ 2 });
+    event_queue.emit_events(event_manager);
+    ASSERT_TRUE(values.empty());
+
+    event_queue.sync_and_emit_events(event_manager);
+    ASSERT_EQ(values, std::vector<int>({ 1, 2 }));
+}
+
+TEST(async_event_queue_tests, test_emit_to_several_event_managers)
+{
+    evnt::async_event_queue event_queue;
+    evnt::event_manager event_manager;
+    evnt::event_manager event_manager_2;
+    evnt::event_box event_box;
+    evnt::event_box event_box_2;
+    event_box.subscribe<int_event>();
+    event_box_2.subscribe<int_event>();
+    event_manager.connect(event_box);
+    event_manager_2.connect(event_box_2);
+    int count = 0;
+    int count_2 = 0;
+    event_manager.connect<int_event>([&count](int_event&) { ++count; });
+    event_manager_2.connect<int_event>([&count_2](int_event&) { ++count_2; });
+
+    event_queue.push(int_event{ 1 });
+    event_queue.push(int_event{ 2 });
+    event_queue.sync();
+    event_queue.emit_events(event_manager);
+    event_queue.emit_events(event_manager_2);
+    ASSERT_EQ(count, 2);
+    ASSERT_EQ(count_2, 2);
+    ASSERT_EQ(event_queue.events<int_event>().size(), 2);
+    ASSERT_EQ(event_box.pending_event_count(), 2);
+    ASSERT_EQ(event_box_2.pending_event_count(), 2);
+}
+
+TEST(async_event_queue_tests, test_lock_free_push)
+{
+    constexpr int number_of_producers = 8;
+    constexpr int number_of_events = 1000;
+
+    evnt::async_event_queue event_queue;
+    event_queue.set_push_mode<producer_event>(evnt::async_event_queue::push_mode::lock_free);
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < number_of_producers; ++producer)
+        producers.emplace_back([&event_queue, producer]
+        {
+            for (int value = 0; value < number_of_events; ++value)
+                event_queue.push(producer_event{ producer, value });
+        });
+    for (std::thread& producer : producers)
+        producer.join();
+
+    evnt::event_manager event_manager;
+    std::vector<int> next_values(number_of_producers, 0);
+    bool in_order = true;
+    event_manager.connect<producer_event>([&](producer_event& event)
+    {
+        in_order = in_order && event.value == next_values[event.producer];
+        ++next_values[event.producer];
+    });
+    event_queue.sync_and_emit_events(event_manager);
+
+    ASSERT_TRUE(in_order);
+    for (int next_value : next_values)
+        ASSERT_EQ(next_value, number_of_events);
+    ASSERT_EQ(event_queue.events<producer_event>().size(), std::size_t(number_of_producers * number_of_events));
+}
+
+TEST(async_event_queue_tests, test_ring_push)
+{
+    evnt::async_event_queue event_queue;
+    evnt::event_manager event_manager;
+    std::vector<int> values;
+    event_manager.connect<int_event>([&values](int_event& event)
+    {
+        values.push_back(event.value);
+    });
+    event_queue.reserve<int_event>(2);
+    event_queue.set_push_mode<int_event>(evnt::async_event_queue::push_mode::ring);
+
+    for (int value = 1; value <= 3; ++value)
+        event_queue.push(int_event{ value });
+    event_queue.sync_and_emit_events(event_manager);
+    ASSERT_EQ(values, std::vector<int>({ 1, 2, 3 }));
+    ASSERT_TRUE(event_queue.events<int_event>().empty());
+
+    // The ring (4 events) still holds the last synchronized events: the next ones wrap around, then overflow.
+    std::vector<int_event> events{ { 4 }, { 5 }, { 6 } };
+    event_queue.push_events(std::span<const int_event>(events));
+    for (int value = 7; value <= 9; ++value)
+        event_queue.push(int_event{ value });
+    event_queue.sync_and_emit_events(event_manager);
+    ASSERT_EQ(values, std::vector<int>({ 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+    ASSERT_EQ(event_queue.pending_event_count(), 0);
+}
+
+TEST(async_event_queue_tests, test_ring_concurrent_push)
+{
+    constexpr int number_of_producers = 4;
+    constexpr int number_of_events = 20000;
+
+    evnt::async_event_queue event_queue;
+    event_queue.reserve<producer_event>(32);
+    event_queue.set_push_mode<producer_event>(evnt::async_event_queue::push_mode::ring);
+    evnt::event_manager event_manager;
+    std::vector<long long> sums(number_of_producers, 0);
+    int number_of_received_events = 0;
+    event_manager.connect<producer_event>([&](producer_event& event)
+    {
+        sums[event.producer] += event.value;
+        ++number_of_received_events;
+    });
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < number_of_producers; ++producer)
+        producers.emplace_back([&event_queue, producer]
+        {
+            for (int value = 0; value < number_of_events; ++value)
+                event_queue.push(producer_event{ producer, value });
+        });
+    while (number_of_received_events < number_of_producers * number_of_events)
+        event_queue.sync_and_emit_events(event_manager);
+    for (std::thread& producer : producers)
+        producer.join();
+
+    for (long long sum : sums)
+        ASSERT_EQ(sum, (long long)number_of_events * (number_of_events - 1) / 2);
+}
+
+template <std::size_t tag>
+class tagged_event
+{
+public:
+    int value;
+};
+
+template <std::size_t... tags>
+void push_tagged_events(evnt::async_event_queue& event_queue, int value, std::index_sequence<tags...>)
+{
+    (event_queue.push(tagged_event<tags>{ value }), ...);
+}
+
+template <std::size_t... tags>
+void connect_tagged_events(evnt::event_manager& event_manager, int& sum, std::index_sequence<tags...>)
+{
+    (event_manager.connect<tagged_event<tags>>([&sum](tagged_event<tags>& event) { sum += event.value; }), ...);
+}
+
+TEST(async_event_queue_tests, test_concurrent_event_type_creation)
+{
+    constexpr int number_of_producers = 8;
+    constexpr std::size_t number_of_event_types = 40;
+
+    evnt::async_event_queue event_queue;
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < number_of_producers; ++producer)
+        producers.emplace_back([&event_queue]
+        {
+            push_tagged_events(event_queue, 1, std::make_index_sequence<number_of_event_types>());
+        });
+    for (std::thread& producer : producers)
+        producer.join();
+
+    evnt::event_manager event_manager;
+    int sum = 0;
+    connect_tagged_events(event_manager, sum, std::make_index_sequence<number_of_event_types>());
+    event_queue.sync_and_emit_events(event_manager);
+    ASSERT_EQ(sum, int(number_of_producers * number_of_event_types));
+}
+
+std::vector<int> bounded_queue_values(evnt::async_event_queue::overflow_policy policy, std::size_t& number_of_dropped_events)
+{
+    evnt::async_event_queue event_queue;
+    event_queue.set_capacity<int_event>(3, policy);
+    for (int value = 1; value <= 5; ++value)
+        event_queue.push(int_event{ value });
+    event_queue.sync();
+    evnt::async_event_queue::overflow_counters counters = event_queue.counters<int_event>();
+    number_of_dropped_events = counters.dropped_events + counters.coalesced_events;
+    if (event_queue.pending_event_count() != 0)
+        return {};
+
+    std::vector<int> values;
+    for (const int_event& event : event_queue.events<int_event>())
+        values.push_back(event.value);
+    return values;
+}
+
+TEST(async_event_queue_tests, test_bounded_queue_drop_policies)
+{
+    using overflow_policy = evnt::async_event_queue::overflow_policy;
+    std::size_t number_of_dropped_events = 0;
+    ASSERT_EQ(bounded_queue_values(overflow_policy::drop_newest, number_of_dropped_events), std::vector<int>({ 1, 2, 3 }));
+    ASSERT_EQ(number_of_dropped_events, 2);
+    ASSERT_EQ(bounded_queue_values(overflow_policy::drop_oldest, number_of_dropped_events), std::vector<int>({ 3, 4, 5 }));
+    ASSERT_EQ(number_of_dropped_events, 2);
+    ASSERT_EQ(bounded_queue_values(overflow_policy::coalesce, number_of_dropped_events), std::vector<int>({ 1, 2, 5 }));
+    ASSERT_EQ(number_of_dropped_events, 2);
+}
+
+TEST(async_event_queue_tests, test_bounded_queue_block)
+{
+    evnt::async_event_queue event_queue;
+    event_queue.set_capacity<int_event>(2);
+    std::thread producer([&event_queue]
+    {
+        std::vector<int_event> events{ { 1 }, { 2 }, { 3 }, { 4 } };
+        event_queue.push_events(std::span<const int_event>(events));
+        event_queue.push(int_event{ 5 });
+    });
+
+    std::vector<int> values;
+    while (values.size() < 5)
+    {
+        event_queue.sync();
+        const std::pmr::vector<int_event>& events = event_queue.events<int_event>();
+        ASSERT_LE(events.size(), 2);
+        for (const int_event& event : events)
+            values.push_back(event.value);
+        std::this_thread::yield();
+    }
+    producer.join();
+    ASSERT_EQ(values, std::vector<int>({ 1, 2, 3, 4, 5 }));
+    ASSERT_GE(event_queue.counters<int_event>().blocked_pushes, 1);
+}
+
+class position_event
+{
+public:
+    int entity;
+    int position;
+};
+
+TEST(async_event_queue_tests, test_coalescing)
+{
+    evnt::async_event_queue event_queue;
+    evnt::event_manager event_manager;
+    std::vector<std::pair<int, int>> positions;
+    event_manager.connect<position_event>([&positions](position_event& event)
+    {
+        positions.emplace_back(event.entity, event.position);
+    });
+    std::vector<int> values;
+    event_manager.connect<int_event>([&values](int_event& event)
+    {
+        values.push_back(event.value);
+    });
+
+    event_queue.set_coalescing<position_event>([](const position_event& event) { return event.entity; });
+    event_queue.set_coalescing<int_event>();
+    for (int position = 0; position < 10; ++position)
+    {
+        event_queue.push(position_event{ 1, position });
+        event_queue.push(position_event{ 2, -position });
+        event_queue.push(int_event{ position });
+    }
+    event_queue.sync_and_emit_events(event_manager);
+    using position_vector = std::vector<std::pair<int, int>>;
+    ASSERT_EQ(positions, position_vector({ { 1, 9 }, { 2, -9 } }));
+    ASSERT_EQ(values, std::vector<int>({ 9 }));
+    ASSERT_EQ(event_queue.counters<position_event>().coalesced_events, 18);
+    ASSERT_EQ(event_queue.pending_event_count(), 0);
+
+    event_queue.push(position_event{ 2, 5 });
+    event_queue.sync_and_emit_events(event_manager);
+    ASSERT_EQ(positions.back(), std::make_pair(2, 5));
+}
+
+TEST(async_event_queue_tests, test_priorities_and_deadline)
+{
+    evnt::async_event_queue event_queue;
+    evnt::event_manager event_manager;
+    std::vector<int> values;
+    event_manager.connect<int_event>([&values](int_event& event)
+    {
+        values.push_back(event.value);
+    });
+    event_manager.connect<position_event>([&values](position_event& event)
+    {
+        values.push_back(event.position);
+    });
+
+    event_queue.push(int_event{ 1 });
+    event_queue.push(position_event{ 0, 2 });
+    event_queue.sync_and_emit_events(event_manager);
+    ASSERT_EQ(values, std::vector<int>({ 1, 2 }));
+
+    event_queue.set_priority<position_event>(1);
+    event_queue.push(int_event{ 3 });
+    event_queue.push(position_event{ 0, 4 });
+    event_queue.sync_and_emit_events(event_manager);
+    ASSERT_EQ(values, std::vector<int>({ 1, 2, 4, 3 }));
+
+    // No type is processed once the deadline is reached.
+    event_queue.push(int_event{ 5 });
+    event_queue.push(position_event{ 0, 6 });
+    ASSERT_FALSE(event_queue.sync_and_emit_events(event_manager, std::chrono::steady_clock::time_point()));
+    ASSERT_EQ(values, std::vector<int>({ 1, 2, 4, 3 }));
+    ASSERT_EQ(event_queue.pending_event_count(), 2);
+    ASSERT_TRUE(event_queue.sync_and_emit_events(event_manager, std::chrono::seconds(10)));
+    ASSERT_EQ(values, std::vector<int>({ 1, 2, 4, 3, 6, 5 }));
+}
+
+TEST(async_event_queue_tests, test_deadline_resumes_pass)
+{
+    evnt::async_event_queue event_queue;
+    evnt::event_manager event_manager;
+    std::vector<int> values;
+    // Each call only has the time to emit one type.
+    event_manager.connect<position_event>([&values](position_event& event)
+    {
+        values.push_back(event.position);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    });
+    event_manager.connect<int_event>([&values](int_event& event)
+    {
+        values.push_back(event.value);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    });
+    event_manager.connect<producer_event>([&values](producer_event& event)
+    {
+        values.push_back(event.value);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    });
+    event_queue.set_priority<position_event>(1);
+
+    // The high priority type is pushed again before every call, the low priority ones still make progress.
+    for (int index = 0; index < 4; ++index)
+    {
+        event_queue.push(position_event{ 0, 0 });
+        if (index == 0)
+        {
+            event_queue.push(int_event{ 1 });
+            event_queue.push(producer_event{ 0, 2 });
+        }
+        event_queue.sync_and_emit_events(event_manager, std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(values.size(), 6);
+    ASSERT_EQ(values[0], 0);
+    ASSERT_EQ(values[1] + values[2], 3);
+    ASSERT_EQ(values[5], 0);
+
+    // Types with the same priority take turns being emitted first.
+    event_queue.push(int_event{ 3 });
+    event_queue.push(producer_event{ 0, 4 });
+    ASSERT_TRUE(event_queue.sync_and_emit_events(event_manager, std::chrono::seconds(10)));
+    ASSERT_EQ(values.size(), 8);
+    ASSERT_EQ(values[6], values[1] == 1 ? 4 : 3);
+}
+
+class counting_resource : public std::pmr::memory_resource
+{
+public:
+    std::size_t number_of_allocations = 0;
+    std::size_t number_of_allocated_bytes = 0;
+
+private:
+    virtual void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++number_of_allocations;
+        number_of_allocated_bytes += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    virtual void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override
+    {
+        number_of_allocated_bytes -= bytes;
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    virtual bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+class message_event
+{
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    explicit message_event(std::string_view text, const allocator_type& allocator = {}) : text(text, allocator) {}
+    message_event(const message_event& other, const allocator_type& allocator = {}) : text(other.text, allocator) {}
+    message_event(message_event&& other) = default;
+    message_event(message_event&& other, const allocator_type& allocator) : text(std::move(other.text), allocator) {}
+    message_event& operator=(const message_event&) = default;
+    message_event& operator=(message_event&&) = default;
+
+    std::pmr::string text;
+};
+
+TEST(async_event_queue_tests, test_memory_resource)
+{
+    counting_resource resource;
+    evnt::async_event_queue event_queue(&resource);
+    evnt::event_manager event_manager(&resource);
+    std::vector<std::string> texts;
+    event_manager.connect<message_event>([&texts, &resource](message_event& event)
+    {
+        ASSERT_EQ(event.text.get_allocator().resource(), &resource);
+        texts.emplace_back(event.text);
+    });
+    std::size_t number_of_allocations = resource.number_of_allocations;
+    ASSERT_GT(number_of_allocations, 0);
+
+    const std::string text(64, 'a');
+    event_queue.push(message_event(text));
+    event_queue.set_push_mode<message_event>(evnt::async_event_queue::push_mode::lock_free);
+    event_queue.push(message_event(text));
+    event_queue.sync_and_emit_events(event_manager);
+    ASSERT_EQ(texts, std::vector<std::string>(2, text));
+    ASSERT_GT(resource.number_of_allocations, number_of_allocations);
+}
+
+TEST(async_event_queue_tests, test_queues_memory_resource)
+{
+    counting_resource resource;
+    {
+        evnt::async_event_queue event_queue(&resource);
+        ASSERT_EQ(resource.number_of_allocations, 0);
+        // More types than the first segment of the queue table: each type allocates its queue and its events.
+        push_tagged_events(event_queue, 1, std::make_index_sequence<40>());
+        ASSERT_GE(resource.number_of_allocations, 2 * 40);
+        event_queue.set_push_mode<tagged_event<0>>(evnt::async_event_queue::push_mode::ring);
+        event_queue.set_coalescing<tagged_event<1>>([](const tagged_event<1>& event) { return event.value; });
+    }
+    ASSERT_EQ(resource.number_of_allocated_bytes, 0);
+}
+
+TEST(async_event_queue_tests, test_as_pushed_delivery_order)
+{
+    evnt::async_event_queue event_queue(evnt::async_event_queue::delivery_order::as_pushed);
+    evnt::event_manager event_manager;
+    std::vector<std::string> received_events;
+    event_manager.connect<int_event>([&received_events](int_event& event)
+    {
+        received_events.push_back(std::to_string(event.value));
+    });
+    event_manager.connect<message_event>([&received_events](message_event& event)
+    {
+        received_events.emplace_back(event.text);
+    });
+
+    const std::string long_text(100, 'x');
+    for (int round = 0; round < 2; ++round)
+    {
+        received_events.clear();
+        event_queue.push(int_event{ 1 });
+        event_queue.push(message_event("a"));
+        event_queue.push(int_event{ 2 });
+        std::vector<message_event> messages{ message_event(long_text), message_event("b") };
+        event_queue.push_events(std::span<const message_event>(messages));
+        event_queue.push(int_event{ 3 });
+        ASSERT_EQ(event_queue.pending_event_count(), 6);
+        event_queue.sync_and_emit_events(event_manager);
+        ASSERT_EQ(received_events, std::vector<std::string>({ "1", "a", "2", long_text, "b", "3" }));
+        ASSERT_EQ(event_queue.pending_event_count(), 0);
+    }
+
+    // Many events span several blocks.
+    received_events.clear();
+    for (int value = 0; value < 10000; ++value)
+        event_queue.push(int_event{ value });
+    event_queue.sync_and_emit_events(event_manager);
+    ASSERT_EQ(received_events.size(), 10000);
+    ASSERT_EQ(received_events.back(), "9999");
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,99 @@
+#include <evnt/delegate.hpp>
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdlib>
+#include <memory>
+
+class int_event
+{
+public:
+    int value;
+};
+
+class int_event_receiver
+{
+public:
+    void receive(int_event& event)
+    {
+        value = event.value;
+    }
+
+    int value = 0;
+};
+
+TEST(delegate_tests, test_empty)
+{
+    evnt::delegate<void(int_event&)> function;
+    ASSERT_FALSE(function);
+    ASSERT_TRUE(function == nullptr);
+
+    void(*function_ptr)(int_event&) = nullptr;
+    evnt::delegate<void(int_event&)> function_2(function_ptr);
+    ASSERT_TRUE(function_2 == nullptr);
+}
+
+TEST(delegate_tests, test_lambda)
+{
+    int value = 0;
+    evnt::delegate<void(int_event&)> function([&value](int_event& event)
+    {
+        value = event.value;
+    });
+    ASSERT_TRUE(function);
+
+    int_event evt{ 5 };
+    function(evt);
+    ASSERT_EQ(value, 5);
+}
+
+TEST(delegate_tests, test_bind)
+{
+    int_event_receiver receiver;
+    auto function = evnt::delegate<void(int_event&)>::bind<&int_event_receiver::receive>(receiver);
+
+    int_event evt{ 7 };
+    function(evt);
+    ASSERT_EQ(receiver.value, 7);
+}
+
+TEST(delegate_tests, test_large_callable)
+{
+    std::array<int, 16> values{};
+    evnt::delegate<int(int)> function([values](int index) mutable
+    {
+        return ++values[index];
+    });
+    ASSERT_EQ(function(3), 1);
+
+    evnt::delegate<int(int)> copy(function);
+    ASSERT_EQ(copy(3), 2);
+    ASSERT_EQ(function(3), 2);
+}
+
+TEST(delegate_tests, test_copy_and_move)
+{
+    std::shared_ptr<int> counter = std::make_shared<int>(0);
+    evnt::delegate<void()> function([counter] { ++*counter; });
+    ASSERT_EQ(counter.use_count(), 2);
+
+    evnt::delegate<void()> copy = function;
+    ASSERT_EQ(counter.use_count(), 3);
+
+    evnt::delegate<void()> moved = std::move(function);
+    ASSERT_EQ(counter.use_count(), 3);
+    ASSERT_FALSE(function);
+
+    copy();
+    moved();
+    ASSERT_EQ(*counter, 2);
+
+    copy = nullptr;
+    moved = nullptr;
+    ASSERT_EQ(counter.use_count(), 1);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,97 @@
+#include <evnt/evnt.hpp>
+#include <gtest/gtest.h>
+#include <coroutine>
+#include <exception>
+#include <vector>
+
+class int_event
+{
+public:
+    int value;
+};
+
+// Coroutine started eagerly, destroyed with the task.
+class task
+{
+public:
+    struct promise_type
+    {
+        task get_return_object() { return task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    explicit task(std::coroutine_handle<promise_type> coroutine) : coroutine_(coroutine) {}
+    task(const task&) = delete;
+    ~task() { coroutine_.destroy(); }
+
+    bool done() const { return coroutine_.done(); }
+
+private:
+    std::coroutine_handle<promise_type> coroutine_;
+};
+
+template <class event_source>
+task receive_two_events(event_source& source, std::vector<int>& values)
+{
+    int_event event = co_await source.template next<int_event>();
+    values.push_back(event.value);
+    event = co_await source.template next<int_event>();
+    values.push_back(event.value);
+}
+
+TEST(event_awaiter_tests, test_event_manager_next)
+{
+    evnt::event_manager event_manager;
+    std::vector<int> values;
+    int number_of_calls = 0;
+    event_manager.connect<int_event>([&number_of_calls](int_event&) { ++number_of_calls; });
+
+    task receiver = receive_two_events(event_manager, values);
+    ASSERT_TRUE(values.empty());
+    event_manager.emit(int_event{ 1 });
+    ASSERT_EQ(values, std::vector<int>({ 1 }));
+    event_manager.emit(int_event{ 2 });
+    ASSERT_EQ(values, std::vector<int>({ 1, 2 }));
+    ASSERT_TRUE(receiver.done());
+    event_manager.emit(int_event{ 3 });
+    ASSERT_EQ(values, std::vector<int>({ 1, 2 }));
+    ASSERT_EQ(number_of_calls, 3);
+}
+
+TEST(event_awaiter_tests, test_destroy_waiting_coroutine)
+{
+    evnt::event_manager event_manager;
+    std::vector<int> values;
+    {
+        task receiver = receive_two_events(event_manager, values);
+        event_manager.emit(int_event{ 1 });
+        ASSERT_FALSE(receiver.done());
+    }
+    event_manager.emit(int_event{ 2 });
+    ASSERT_EQ(values, std::vector<int>({ 1 }));
+}
+
+TEST(event_awaiter_tests, test_event_box_next)
+{
+    evnt::event_manager event_manager;
+    evnt::event_box event_box;
+    event_manager.connect(event_box);
+    std::vector<int> values;
+
+    task receiver = receive_two_events(event_box, values);
+    event_manager.emit(int_event{ 1 });
+    event_manager.emit(int_event{ 2 });
+    ASSERT_TRUE(values.empty());
+    event_box.emit_received_events();
+    ASSERT_EQ(values, std::vector<int>({ 1, 2 }));
+    ASSERT_TRUE(receiver.done());
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,77 @@
+#include <evnt/evnt.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct int_event
+{
+    int value;
+};
+
+struct text_event
+{
+    std::string text;
+};
+
+TEST(event_batch_tests, test_flush)
+{
+    evnt::event_manager event_manager;
+    evnt::event_box event_box;
+    event_manager.connect(event_box);
+    std::vector<int> local_values;
+    std::vector<int> values;
+    event_manager.connect<int_event>([&local_values](int_event& event) { local_values.push_back(event.value); });
+    event_box.connect<int_event>([&values](int_event& event) { values.push_back(event.value); });
+
+    {
+        evnt::event_batch batch(event_manager);
+        batch.emit(int_event{ 1 });
+        int_event event{ 2 };
+        batch.emit(event);
+        ASSERT_EQ(local_values, std::vector<int>({ 1, 2 }));
+        ASSERT_EQ(batch.staged_event_count(), 2);
+        ASSERT_EQ(event_box.pending_event_count(), 0);
+
+        batch.flush();
+        ASSERT_EQ(batch.staged_event_count(), 0);
+        ASSERT_EQ(event_box.pending_event_count(), 2);
+        batch.emit(int_event{ 3 });
+    }
+    event_box.emit_received_events();
+    ASSERT_EQ(values, std::vector<int>({ 1, 2, 3 }));
+}
+
+TEST(event_batch_tests, test_as_pushed_delivery_order)
+{
+    evnt::event_manager event_manager;
+    evnt::event_box event_box(evnt::async_event_queue::delivery_order::as_pushed);
+    evnt::event_box event_box_2;
+    event_manager.connect(event_box);
+    event_manager.connect(event_box_2);
+    std::vector<std::string> texts;
+    event_box.connect<int_event>([&texts](int_event& event) { texts.push_back(std::to_string(event.value)); });
+    event_box.connect<text_event>([&texts](text_event& event) { texts.push_back(event.text); });
+    int sum = 0;
+    event_box_2.connect<int_event>([&sum](int_event& event) { sum += event.value; });
+
+    std::thread producer([&event_manager]
+    {
+        evnt::event_batch batch(event_manager);
+        batch.emit(int_event{ 1 });
+        batch.emit(int_event{ 2 });
+        batch.emit(text_event{ "three" });
+        batch.emit(int_event{ 4 });
+    });
+    producer.join();
+    event_box.emit_received_events();
+    event_box_2.emit_received_events();
+    ASSERT_EQ(texts, std::vector<std::string>({ "1", "2", "three", "4" }));
+    ASSERT_EQ(sum, 7);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
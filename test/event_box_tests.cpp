@@ -1,6 +1,11 @@
 #include <evnt/evnt.hpp>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
 
 class int_event
 {
@@ -35,6 +40,7 @@ TEST(event_box_tests, test_connection_2)
     evnt::event_manager event_manager;
 
     evnt::event_box event_box;
+    event_box.subscribe<int_event>();
     event_manager.connect(event_box);
     event_manager.emit(int_event{ 5 });
 
@@ -49,6 +55,45 @@ TEST(event_box_tests, test_connection_2)
     ASSERT_EQ(value, 5);
 }
 
+TEST(event_box_tests, test_unsubscribed_event_types_are_not_queued)
+{
+    evnt::event_manager event_manager;
+    evnt::event_box event_box;
+    event_manager.connect(event_box);
+    event_manager.emit(int_event{ 5 });
+
+    int value = 0;
+    event_box.connect<int_event>([&value](int_event& event)
+    {
+        value = event.value;
+    });
+    event_box.emit_received_events();
+    ASSERT_EQ(value, 0);
+
+    event_manager.emit(int_event{ 7 });
+    event_box.emit_received_events();
+    ASSERT_EQ(value, 7);
+}
+
+TEST(event_box_tests, test_emit_batch)
+{
+    evnt::event_manager event_manager;
+    evnt::event_box event_box;
+    std::vector<int> values;
+    event_box.connect<int_event>([&values](int_event& event)
+    {
+        values.push_back(event.value);
+    });
+    event_manager.connect(event_box);
+
+    std::vector<int_event> events{ { 1 }, { 2 }, { 3 } };
+    event_manager.emit(events);
+    ASSERT_TRUE(values.empty());
+
+    event_box.emit_received_events();
+    ASSERT_EQ(values, std::vector<int>({ 1, 2, 3 }));
+}
+
 TEST(event_box_tests, test_auto_deconnection)
 {
     evnt::event_manager event_manager;
@@ -69,6 +114,286 @@ TEST(event_box_tests, test_auto_deconnection)
     event_manager.emit(int_event{ 8 });
 }
 
+TEST(event_box_tests, test_connection_while_emitting)
+{
+    evnt::event_manager event_manager;
+    std::atomic_bool stop = false;
+    std::thread emitter([&]
+    {
+        while (!stop)
+            event_manager.emit(int_event{ 1 });
+    });
+
+    int value = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        evnt::event_box event_box;
+        event_box.connect<int_event>([&value](int_event& event)
+        {
+            value = event.value;
+        });
+        event_manager.connect(event_box);
+        event_box.emit_received_events();
+    }
+    stop = true;
+    emitter.join();
+}
+
+TEST(event_box_tests, test_destruction_while_connecting)
+{
+    evnt::event_manager event_manager;
+    std::atomic_bool stop = false;
+    std::thread connector([&]
+    {
+        evnt::event_box event_box;
+        event_box.subscribe<int_event>();
+        while (!stop)
+        {
+            event_manager.connect(event_box);
+            event_manager.disconnect(event_box);
+        }
+    });
+
+    for (int i = 0; i < 100; ++i)
+    {
+        std::vector<std::unique_ptr<evnt::event_box>> event_boxes;
+        for (int j = 0; j < 100; ++j)
+        {
+            event_boxes.push_back(std::make_unique<evnt::event_box>());
+            event_boxes.back()->subscribe<int_event>();
+            event_manager.connect(*event_boxes.back());
+        }
+    }
+    stop = true;
+    connector.join();
+}
+
+TEST(event_box_tests, test_connection_while_producer_blocked)
+{
+    evnt::event_manager event_manager;
+    evnt::event_box event_box;
+    std::vector<int> values;
+    event_box.connect<int_event>([&values](int_event& event) { values.push_back(event.value); });
+    event_box.set_capacity<int_event>(1);
+    event_manager.connect(event_box);
+
+    event_manager.emit(int_event{ 1 });
+    std::thread producer([&event_manager]
+    {
+        event_manager.emit(int_event{ 2 });
+    });
+    while (event_box.counters<int_event>().blocked_pushes == 0)
+        std::this_thread::yield();
+
+    // The consumer connects and destroys a box while the producer waits for it.
+    {
+        evnt::event_box event_box_2;
+        event_box_2.subscribe<int_event>();
+        event_manager.connect(event_box_2);
+    }
+    while (values.size() < 2)
+    {
+        event_box.emit_received_events();
+        std::this_thread::yield();
+    }
+    producer.join();
+    ASSERT_EQ(values, std::vector<int>({ 1, 2 }));
+    ASSERT_EQ(event_box.counters<int_event>().blocked_pushes, 1);
+}
+
+class large_event
+{
+public:
+    int values[256];
+};
+
+TEST(event_box_tests, test_shared_event)
+{
+    evnt::event_manager event_manager;
+    evnt::event_box event_box;
+    evnt::event_box event_box_2;
+    event_manager.connect(event_box);
+    event_manager.connect(event_box_2);
+
+    const large_event* address = nullptr;
+    const large_event* address_2 = nullptr;
+    int value = 0;
+    event_box.connect<evnt::shared_event<large_event>>([&](evnt::shared_event<large_event>& event)
+    {
+        address = &event.get();
+        value = event->values[255];
+    });
+    event_box_2.connect<evnt::shared_event<large_event>>([&](evnt::shared_event<large_event>& event)
+    {
+        address_2 = &*event;
+    });
+
+    large_event event{};
+    event.values[255] = 5;
+    event_manager.emit_shared(event);
+    event_box.emit_received_events();
+    event_box_2.emit_received_events();
+    ASSERT_EQ(value, 5);
+    ASSERT_NE(address, nullptr);
+    ASSERT_EQ(address, address_2);
+}
+
+TEST(event_box_tests, test_shared_event_local_receivers)
+{
+    evnt::event_manager event_manager;
+    evnt::event_box event_box;
+    event_manager.connect(event_box);
+
+    int value = 0;
+    int shared_value = 0;
+    int box_value = 0;
+    event_manager.connect<large_event>([&](large_event& event) { value = event.values[0]; });
+    event_manager.connect<evnt::shared_event<large_event>>([&](evnt::shared_event<large_event>& event)
+    {
+        shared_value = event->values[0];
+    });
+    event_box.connect<large_event>([&](large_event& event) { box_value = event.values[0]; });
+    event_box.connect<evnt::shared_event<large_event>>([&](evnt::shared_event<large_event>& event)
+    {
+        box_value += event->values[0] * 10;
+    });
+
+    event_manager.emit_shared(large_event{ { 3 } });
+    ASSERT_EQ(value, 3);
+    ASSERT_EQ(shared_value, 3);
+    // The box only receives the shared event.
+    event_box.emit_received_events();
+    ASSERT_EQ(box_value, 30);
+}
+
+TEST(event_box_tests, test_as_pushed_delivery_order)
+{
+    evnt::event_manager event_manager;
+    evnt::event_box event_box(evnt::async_event_queue::delivery_order::as_pushed);
+    event_manager.connect(event_box);
+    std::vector<int> values;
+    event_box.connect<int_event>([&values](int_event& event) { values.push_back(event.value); });
+    event_box.connect<large_event>([&values](large_event& event) { values.push_back(event.values[0]); });
+
+    event_manager.emit(int_event{ 1 });
+    event_manager.emit(large_event{ { 2 } });
+    event_manager.emit(int_event{ 3 });
+    event_box.emit_received_events();
+    ASSERT_EQ(values, std::vector<int>({ 1, 2, 3 }));
+}
+
+TEST(event_box_tests, test_event_box_tree)
+{
+    evnt::event_manager event_manager;
+    evnt::event_box root_box;
+    evnt::event_box inner_box;
+    evnt::event_box leaf_box;
+    evnt::event_box leaf_box_2;
+    event_manager.connect(root_box);
+    root_box.connect(inner_box);
+    inner_box.connect(leaf_box);
+    root_box.connect(leaf_box_2);
+
+    std::vector<int> values;
+    std::vector<int> values_2;
+    leaf_box.connect<int_event>([&values](int_event& event)
+    {
+        values.push_back(event.value);
+        event.value += 100;
+    });
+    leaf_box_2.connect<int_event>([&values_2](int_event& event)
+    {
+        values_2.push_back(event.value);
+        event.value += 100;
+    });
+    int large_value = 0;
+    leaf_box_2.connect<large_event>([&large_value](large_event& event) { large_value = event.values[0]; });
+
+    // Subscriptions go up the tree: inner_box only receives int_event.
+    event_manager.emit(int_event{ 1 });
+    event_manager.emit(int_event{ 2 });
+    event_manager.emit(large_event{ { 3 } });
+    ASSERT_EQ(root_box.pending_event_count(), 3);
+    root_box.emit_received_events();
+    ASSERT_EQ(inner_box.pending_event_count(), 2);
+    ASSERT_EQ(leaf_box_2.pending_event_count(), 3);
+
+    // Whichever box consumes the shared batch first, the other one gets the original events.
+    leaf_box_2.emit_received_events();
+    inner_box.emit_received_events();
+    leaf_box.emit_received_events();
+    ASSERT_EQ(values, std::vector<int>({ 1, 2 }));
+    ASSERT_EQ(values_2, std::vector<int>({ 1, 2 }));
+    ASSERT_EQ(large_value, 3);
+
+    event_manager.emit(int_event{ 4 });
+    root_box.emit_received_events();
+    inner_box.emit_received_events();
+    leaf_box.emit_received_events();
+    leaf_box_2.emit_received_events();
+    ASSERT_EQ(values, std::vector<int>({ 1, 2, 4 }));
+    ASSERT_EQ(values_2, std::vector<int>({ 1, 2, 4 }));
+
+    root_box.disconnect(leaf_box_2);
+    event_manager.emit(int_event{ 5 });
+    root_box.emit_received_events();
+    ASSERT_EQ(leaf_box_2.pending_event_count(), 0);
+}
+
+TEST(event_box_tests, test_forwarded_and_pushed_events_order)
+{
+    evnt::event_manager event_manager;
+    evnt::event_box event_box;
+    event_manager.connect(event_box);
+    std::vector<int> values;
+    event_box.connect<int_event>([&values](int_event& event) { values.push_back(event.value); });
+
+    evnt::async_event_queue event_queue;
+    event_manager.emit(int_event{ 1 });
+    event_queue.push(int_event{ 2 });
+    event_queue.push(int_event{ 3 });
+    event_queue.sync_and_emit_events(event_manager);
+    event_manager.emit(int_event{ 4 });
+    event_box.emit_received_events();
+    ASSERT_EQ(values, std::vector<int>({ 1, 2, 3, 4 }));
+}
+
+TEST(event_box_tests, test_stats)
+{
+    evnt::event_manager event_manager;
+    evnt::event_box event_box;
+    event_manager.connect(event_box);
+    int sum = 0;
+    event_box.connect<int_event>([&sum](int_event& event) { sum += event.value; });
+    event_box.connect<int_event>([&sum](int_event& event) { sum += event.value; });
+
+    event_manager.emit(int_event{ 1 });
+    event_manager.emit(int_event{ 2 });
+    event_box.emit_received_events();
+    event_manager.emit(int_event{ 3 });
+    event_box.emit_received_events();
+    ASSERT_EQ(sum, 12);
+
+    std::vector<evnt::event_type_stats> stats = event_box.stats();
+    if constexpr (!evnt::stats_enabled)
+    {
+        ASSERT_TRUE(stats.empty());
+        return;
+    }
+    auto iter = std::find_if(stats.begin(), stats.end(), [](const evnt::event_type_stats& type_stats)
+    {
+        return type_stats.type_index == evnt::event_info::type_index<int_event>();
+    });
+    ASSERT_NE(iter, stats.end());
+    ASSERT_EQ(iter->pushed_events, 3);
+    ASSERT_EQ(iter->max_queue_depth, 2);
+    ASSERT_EQ(iter->delivery_latency.count, 2);
+    ASSERT_EQ(iter->emitted_events, 3);
+    ASSERT_EQ(iter->receiver_invocations, 6);
+    ASSERT_EQ(iter->receivers, 2);
+    ASSERT_EQ(iter->dispatch_time.count, 2);
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,128 @@
+#include <evnt/evnt.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class int_event
+{
+public:
+    int value;
+};
+
+template <class predicate_type>
+bool wait_until(predicate_type predicate)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!predicate())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+TEST(event_executor_tests, test_process_boxes)
+{
+    constexpr int number_of_boxes = 8;
+    constexpr int number_of_events = 100;
+
+    evnt::event_manager event_manager;
+    std::vector<std::unique_ptr<evnt::event_box>> event_boxes;
+    std::vector<int> sums(number_of_boxes, 0);
+    std::vector<std::atomic_bool> processing(number_of_boxes);
+    std::atomic_int number_of_received_events = 0;
+    std::atomic_bool concurrent_processing = false;
+    for (int i = 0; i < number_of_boxes; ++i)
+    {
+        std::unique_ptr<evnt::event_box>& event_box = event_boxes.emplace_back(std::make_unique<evnt::event_box>());
+        event_box->connect<int_event>([&, i](int_event& event)
+        {
+            if (processing[i].exchange(true))
+                concurrent_processing = true;
+            sums[i] += event.value;
+            processing[i] = false;
+            ++number_of_received_events;
+        });
+        event_manager.connect(*event_box);
+    }
+
+    evnt::event_executor executor(4);
+    for (std::unique_ptr<evnt::event_box>& event_box : event_boxes)
+        executor.add(*event_box);
+
+    for (int i = 0; i < number_of_events; ++i)
+        event_manager.emit(int_event{ 1 });
+    executor.notify();
+
+    ASSERT_TRUE(wait_until([&] { return number_of_received_events == number_of_boxes * number_of_events; }));
+    for (std::unique_ptr<evnt::event_box>& event_box : event_boxes)
+        executor.remove(*event_box);
+    ASSERT_FALSE(concurrent_processing);
+    for (int sum : sums)
+        ASSERT_EQ(sum, number_of_events);
+}
+
+TEST(event_executor_tests, test_remove_box)
+{
+    evnt::event_manager event_manager;
+    evnt::event_executor executor(2);
+    std::atomic_int value = 0;
+
+    {
+        evnt::event_box event_box;
+        event_box.connect<int_event>([&value](int_event& event)
+        {
+            value = event.value;
+        });
+        event_manager.connect(event_box);
+        executor.add(event_box);
+        event_manager.emit(int_event{ 5 });
+        executor.notify();
+        ASSERT_TRUE(wait_until([&] { return value == 5; }));
+        executor.remove(event_box);
+    }
+
+    event_manager.emit(int_event{ 7 });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_EQ(value, 5);
+}
+
+TEST(event_executor_tests, test_destroy_removed_boxes_while_stealing)
+{
+    evnt::event_manager event_manager;
+    evnt::event_executor executor(4, std::chrono::microseconds(10));
+    std::atomic_int number_of_received_events = 0;
+
+    for (int i = 0; i < 200; ++i)
+    {
+        std::vector<std::unique_ptr<evnt::event_box>> event_boxes;
+        for (int j = 0; j < 4; ++j)
+        {
+            std::unique_ptr<evnt::event_box>& event_box = event_boxes.emplace_back(std::make_unique<evnt::event_box>());
+            event_box->connect<int_event>([&](int_event&) { ++number_of_received_events; });
+            event_manager.connect(*event_box);
+            executor.add(*event_box);
+        }
+        for (int j = 0; j < 10; ++j)
+            event_manager.emit(int_event{ j });
+        executor.notify();
+        // Destroys each box right after its removal, while the workers look for boxes to steal.
+        for (std::unique_ptr<evnt::event_box>& event_box : event_boxes)
+        {
+            executor.remove(*event_box);
+            event_box.reset();
+        }
+    }
+    ASSERT_LE(number_of_received_events, 200 * 4 * 10);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
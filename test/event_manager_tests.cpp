@@ -1,6 +1,9 @@
 #include <evnt/evnt.hpp>
 #include <gtest/gtest.h>
 #include <cstdlib>
+#include <span>
+#include <thread>
+#include <vector>
 
 class int_event
 {
@@ -36,6 +39,32 @@ TEST(event_manager_tests, test_emit_event_rvalue_reference)
     ASSERT_EQ(value, 5);
 }
 
+TEST(event_manager_tests, test_function_deconnection)
+{
+    evnt::event_manager event_manager;
+    int value = 0;
+    std::size_t connection = event_manager.connect<int_event>([&value](int_event& event)
+    {
+        value = event.value;
+    });
+    event_manager.emit(int_event{ 5 });
+    ASSERT_EQ(value, 5);
+
+    event_manager.disconnect<int_event>(connection);
+    event_manager.emit(int_event{ 7 });
+    ASSERT_EQ(value, 5);
+
+    int value_2 = 0;
+    event_manager.connect<int_event>([&value_2](int_event& event)
+    {
+        value_2 = event.value;
+    });
+    event_manager.disconnect<int_event>(connection);
+    event_manager.emit(int_event{ 9 });
+    ASSERT_EQ(value, 5);
+    ASSERT_EQ(value_2, 9);
+}
+
 class int_event_Listener : public evnt::event_listener<int_event>
 {
 public:
@@ -105,6 +134,59 @@ TEST(event_manager_tests, test_listener_deconnection)
     ASSERT_EQ(value, 5 * 10);
 }
 
+class self_disconnecting_listener : public evnt::event_listener<int_event>
+{
+public:
+    void receive(int_event& event)
+    {
+        value += event.value;
+        disconnect<int_event>();
+    }
+
+    int value = 0;
+};
+
+TEST(event_manager_tests, test_listener_deconnection_during_emit)
+{
+    evnt::event_manager event_manager;
+    self_disconnecting_listener listener;
+    int value = 0;
+    event_manager.connect<int_event>(listener);
+    event_manager.connect<int_event>([&value](int_event& event)
+    {
+        value = event.value;
+    });
+
+    event_manager.emit(int_event{ 5 });
+    ASSERT_EQ(listener.value, 5);
+    ASSERT_EQ(value, 5);
+
+    event_manager.emit(int_event{ 7 });
+    ASSERT_EQ(listener.value, 5);
+    ASSERT_EQ(value, 7);
+}
+
+TEST(event_manager_tests, test_listener_connection_during_emit)
+{
+    evnt::event_manager event_manager;
+    int value = 0;
+    int count = 0;
+    event_manager.connect<int_event>([&](int_event&)
+    {
+        if (count++ == 0)
+            event_manager.connect<int_event>([&value](int_event& event)
+            {
+                value += event.value;
+            });
+    });
+
+    event_manager.emit(int_event{ 5 });
+    ASSERT_EQ(value, 5);
+
+    event_manager.emit(int_event{ 7 });
+    ASSERT_EQ(value, 12);
+}
+
 class int_event_2
 {
 public:
@@ -218,6 +300,87 @@ TEST(event_manager_tests, test_multi_listener_deconnections_and_reconnection)
     ASSERT_EQ(value_2, 122);
 }
 
+class batch_listener : public evnt::event_listener<int_event>
+{
+public:
+    void receive(std::span<int_event> events)
+    {
+        ++number_of_batches;
+        for (int_event& event : events)
+            sum += event.value;
+    }
+
+    int number_of_batches = 0;
+    int sum = 0;
+};
+
+TEST(event_manager_tests, test_emit_batch)
+{
+    evnt::event_manager event_manager;
+    batch_listener listener;
+    event_manager.connect<int_event>(listener);
+    std::vector<int> values;
+    event_manager.connect<int_event>([&values](int_event& event)
+    {
+        values.push_back(event.value);
+    });
+
+    std::vector<int_event> events{ { 1 }, { 2 }, { 3 } };
+    event_manager.emit(events);
+    ASSERT_EQ(listener.number_of_batches, 1);
+    ASSERT_EQ(listener.sum, 6);
+    ASSERT_EQ(values, std::vector<int>({ 1, 2, 3 }));
+
+    event_manager.emit(int_event{ 4 });
+    ASSERT_EQ(listener.number_of_batches, 2);
+    ASSERT_EQ(listener.sum, 10);
+
+    listener.disconnect<int_event>();
+    event_manager.emit(std::span<int_event>(events));
+    ASSERT_EQ(listener.number_of_batches, 2);
+    ASSERT_EQ(values.size(), 7);
+}
+
+TEST(event_manager_tests, test_parallel_dispatch)
+{
+    constexpr int number_of_receivers = 64;
+
+    evnt::thread_pool thread_pool(4);
+    evnt::event_manager event_manager;
+    event_manager.set_parallel_dispatch<int_event>(thread_pool);
+
+    std::vector<int> values(number_of_receivers, 0);
+    for (int i = 0; i < number_of_receivers; ++i)
+        event_manager.connect<int_event>([&values, i](int_event& event) { values[i] += event.value; });
+
+    // Ordered receivers run on the emitting thread, before the other ones.
+    std::thread::id emitting_thread = std::this_thread::get_id();
+    std::vector<int> order;
+    bool on_emitting_thread = true;
+    std::size_t second = 0;
+    for (int i = 0; i < 2; ++i)
+    {
+        second = event_manager.connect<int_event>([&, i](int_event&)
+        {
+            on_emitting_thread = on_emitting_thread && std::this_thread::get_id() == emitting_thread;
+            order.push_back(i);
+        }, evnt::dispatch_order::ordered);
+    }
+
+    event_manager.emit(int_event{ 2 });
+    std::vector<int_event> events{ { 1 }, { 3 } };
+    event_manager.emit(events);
+    ASSERT_EQ(values, std::vector<int>(number_of_receivers, 6));
+    ASSERT_EQ(order, std::vector<int>({ 0, 1, 0, 1, 0, 1 }));
+    ASSERT_TRUE(on_emitting_thread);
+
+    event_manager.disconnect<int_event>(second);
+    event_manager.set_sequential_dispatch<int_event>();
+    event_manager.emit(int_event{ 1 });
+    ASSERT_EQ(values, std::vector<int>(number_of_receivers, 7));
+    ASSERT_EQ(order, std::vector<int>({ 0, 1, 0, 1, 0, 1, 0 }));
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
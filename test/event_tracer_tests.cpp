@@ -0,0 +1,126 @@
+#include <evnt/evnt.hpp>
+#include <evnt/event_tracer.hpp>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct int_event
+{
+    int value;
+};
+
+struct position_event
+{
+    int position;
+};
+
+struct message_event
+{
+    int length;
+};
+
+std::string read_file(const std::filesystem::path& path)
+{
+    std::ifstream stream(path);
+    std::ostringstream contents;
+    contents << stream.rdbuf();
+    return contents.str();
+}
+
+std::size_t count_occurrences(const std::string& text, const std::string& pattern)
+{
+    std::size_t count = 0;
+    for (std::size_t position = text.find(pattern); position != std::string::npos; position = text.find(pattern, position + 1))
+        ++count;
+    return count;
+}
+}
+
+TEST(event_tracer_tests, test_write_chrome_trace)
+{
+    evnt::event_manager event_manager;
+    evnt::event_box event_box;
+    event_manager.connect(event_box);
+    int sum = 0;
+    event_box.connect<int_event>([&sum](int_event& event) { sum += event.value; });
+
+    evnt::event_tracer::start();
+    std::thread producer([&event_manager] { event_manager.emit(int_event{ 1 }); });
+    producer.join();
+    event_box.emit_received_events();
+    evnt::event_tracer::stop();
+    event_manager.emit(int_event{ 2 });
+    event_box.emit_received_events();
+    ASSERT_EQ(sum, 3);
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "evnt_event_tracer_tests.json";
+    ASSERT_TRUE(evnt::event_tracer::write_chrome_trace(path));
+    const std::string trace = read_file(path);
+    std::filesystem::remove(path);
+    ASSERT_EQ(trace.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), 0);
+    if constexpr (!evnt::tracing_enabled)
+    {
+        ASSERT_EQ(trace.find("\"ph\""), std::string::npos);
+        return;
+    }
+    for (const char* name : { "\"emit\"", "\"receiver\"", "\"push\"", "\"sync\"", "\"deliver\"", "\"emit_received_events\"" })
+        ASSERT_NE(trace.find(name), std::string::npos) << name;
+    ASSERT_NE(trace.find("\"ph\":\"s\""), std::string::npos);
+    ASSERT_NE(trace.find("\"ph\":\"f\""), std::string::npos);
+    ASSERT_NE(trace.find("int_event"), std::string::npos);
+    ASSERT_EQ(evnt::event_tracer::dropped_records(), 0);
+}
+
+TEST(event_tracer_tests, test_flows_of_push_modes)
+{
+    evnt::async_event_queue event_queue;
+    evnt::event_manager event_manager;
+    event_queue.set_push_mode<position_event>(evnt::async_event_queue::push_mode::lock_free);
+    event_queue.set_push_mode<message_event>(evnt::async_event_queue::push_mode::ring);
+    std::size_t number_of_events = 0;
+    event_manager.connect<int_event>([&number_of_events](int_event&) { ++number_of_events; });
+    event_manager.connect<position_event>([&number_of_events](position_event&) { ++number_of_events; });
+    event_manager.connect<message_event>([&number_of_events](message_event&) { ++number_of_events; });
+
+    evnt::event_tracer::start();
+    std::vector<std::thread> producers;
+    for (int index = 0; index < 4; ++index)
+        producers.emplace_back([&event_queue]
+        {
+            for (int value = 0; value < 25; ++value)
+            {
+                event_queue.push(int_event{ value });
+                event_queue.push(position_event{ value });
+                const message_event messages[2] = { { value }, { value } };
+                event_queue.push_events(std::span<const message_event>(messages));
+            }
+        });
+    for (std::thread& producer : producers)
+        producer.join();
+    event_queue.sync_and_emit_events(event_manager);
+    evnt::event_tracer::stop();
+    ASSERT_EQ(number_of_events, 4 * 25 * 4);
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "evnt_event_tracer_flows_tests.json";
+    ASSERT_TRUE(evnt::event_tracer::write_chrome_trace(path));
+    const std::string trace = read_file(path);
+    std::filesystem::remove(path);
+    if constexpr (!evnt::tracing_enabled)
+        return;
+    // One flow per push, finished at the delivery whatever the push mode.
+    ASSERT_EQ(count_occurrences(trace, "\"ph\":\"s\""), 4 * 25 * 3);
+    ASSERT_EQ(count_occurrences(trace, "\"ph\":\"f\""), 4 * 25 * 3);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
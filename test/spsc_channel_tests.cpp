@@ -0,0 +1,114 @@
+#include <evnt/evnt.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct int_event
+{
+    int value;
+};
+
+struct text_event
+{
+    std::string text;
+};
+
+TEST(spsc_channel_tests, test_emit_received_events)
+{
+    evnt::event_manager source;
+    evnt::event_manager destination;
+    evnt::spsc_channel<text_event> channel(source, 4);
+    ASSERT_EQ(channel.capacity(), 4);
+    std::vector<std::string> texts;
+    destination.connect<text_event>([&texts](text_event& event) { texts.push_back(event.text); });
+
+    source.emit(text_event{ "a" });
+    source.emit(text_event{ "b" });
+    source.emit(text_event{ "c" });
+    ASSERT_TRUE(texts.empty());
+    ASSERT_EQ(channel.emit_received_events(destination), 3);
+    ASSERT_EQ(texts, std::vector<std::string>({ "a", "b", "c" }));
+
+    // Wraps around the ring.
+    std::vector<text_event> events{ { "d" }, { "e" }, { "f" } };
+    source.emit(events);
+    ASSERT_EQ(channel.emit_received_events(destination), 3);
+    ASSERT_EQ(channel.emit_received_events(destination), 0);
+    ASSERT_TRUE(channel.empty());
+    ASSERT_EQ(texts, std::vector<std::string>({ "a", "b", "c", "d", "e", "f" }));
+
+    source.emit(text_event{ "not emitted" });
+}
+
+void test_producer_thread(evnt::wait_policy policy)
+{
+    constexpr int number_of_events = 100000;
+    evnt::event_manager source;
+    evnt::event_manager destination;
+    evnt::spsc_channel<int_event> channel(source, 64, policy);
+    int expected_value = 0;
+    bool in_order = true;
+    destination.connect<int_event>([&](int_event& event)
+    {
+        in_order = in_order && event.value == expected_value;
+        ++expected_value;
+    });
+
+    std::thread producer([&source]
+    {
+        std::vector<int_event> events;
+        for (int value = 0; value < number_of_events;)
+        {
+            if (value % 3 == 0)
+                source.emit(int_event{ value++ });
+            else
+            {
+                events.clear();
+                for (int i = 0; i < 10 && value < number_of_events; ++i)
+                    events.push_back(int_event{ value++ });
+                source.emit(events);
+            }
+        }
+    });
+    while (expected_value < number_of_events)
+    {
+        channel.wait();
+        channel.emit_received_events(destination);
+    }
+    producer.join();
+    ASSERT_TRUE(in_order);
+    ASSERT_EQ(expected_value, number_of_events);
+}
+
+TEST(spsc_channel_tests, test_blocking_wait)
+{
+    test_producer_thread(evnt::wait_policy::blocking);
+}
+
+TEST(spsc_channel_tests, test_busy_poll_wait)
+{
+    test_producer_thread(evnt::wait_policy::busy_poll);
+}
+
+TEST(spsc_channel_tests, test_wake_up)
+{
+    evnt::event_manager source;
+    evnt::spsc_channel<int_event> channel(source);
+    std::atomic_bool running = true;
+    std::thread consumer([&]
+    {
+        while (running)
+            channel.wait();
+    });
+    running = false;
+    channel.wake_up();
+    consumer.join();
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,77 @@
+#include <evnt/evnt.hpp>
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <vector>
+
+class int_event
+{
+public:
+    int value;
+};
+
+class int_event_2
+{
+public:
+    int value;
+};
+
+TEST(static_event_manager_tests, test_emit_event)
+{
+    evnt::static_event_manager<int_event, int_event_2> event_manager;
+    int value = 0;
+    int value_2 = 0;
+    event_manager.connect<int_event>([&value](int_event& event)
+    {
+        value = event.value;
+    });
+    event_manager.connect<int_event_2>([&value_2](int_event_2& event)
+    {
+        value_2 = event.value;
+    });
+
+    int_event evt{ 5 };
+    event_manager.emit(evt);
+    ASSERT_EQ(value, 5);
+    ASSERT_EQ(value_2, 0);
+
+    event_manager.emit(int_event_2{ 7 });
+    ASSERT_EQ(value, 5);
+    ASSERT_EQ(value_2, 7);
+}
+
+TEST(static_event_manager_tests, test_emit_events)
+{
+    evnt::static_event_manager<int_event> event_manager;
+    int sum = 0;
+    event_manager.connect<int_event>([&sum](int_event& event)
+    {
+        sum += event.value;
+    });
+
+    std::vector<int_event> events{ { 1 }, { 2 }, { 3 } };
+    event_manager.emit(events);
+    ASSERT_EQ(sum, 6);
+}
+
+TEST(static_event_manager_tests, test_disconnection)
+{
+    evnt::static_event_manager<int_event> event_manager;
+    int value = 0;
+    std::size_t connection = event_manager.connect<int_event>([&value](int_event& event)
+    {
+        value = event.value;
+    });
+
+    event_manager.emit(int_event{ 5 });
+    ASSERT_EQ(value, 5);
+
+    event_manager.disconnect<int_event>(connection);
+    event_manager.emit(int_event{ 7 });
+    ASSERT_EQ(value, 5);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,43 @@
+#include <evnt/thread_pool.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+
+TEST(thread_pool_tests, test_parallel_for)
+{
+    evnt::thread_pool thread_pool(4);
+    ASSERT_EQ(thread_pool.number_of_threads(), 4);
+
+    for (std::size_t count : { 0, 1, 7, 1000 })
+    {
+        std::vector<std::atomic_int> calls(count);
+        thread_pool.parallel_for(count, [&calls](std::size_t first, std::size_t last)
+        {
+            for (std::size_t i = first; i < last; ++i)
+                ++calls[i];
+        });
+        for (std::atomic_int& number_of_calls : calls)
+            ASSERT_EQ(number_of_calls, 1);
+    }
+}
+
+TEST(thread_pool_tests, test_nested_parallel_for)
+{
+    evnt::thread_pool thread_pool(2);
+    std::atomic_int sum = 0;
+    thread_pool.parallel_for(16, [&](std::size_t first, std::size_t last)
+    {
+        for (std::size_t i = first; i < last; ++i)
+            thread_pool.parallel_for(100, [&sum](std::size_t first, std::size_t last)
+            {
+                sum += int(last - first);
+            });
+    });
+    ASSERT_EQ(sum, 1600);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}